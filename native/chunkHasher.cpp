@@ -0,0 +1,171 @@
+#include "chunkHasher.h"
+
+#include <algorithm>
+#include <array>
+
+#undef min
+
+static constexpr std::array<uint64_t, 256> CreateGearTable() {
+  // splitmix64 with a fixed seed.
+  std::array<uint64_t, 256> table{};
+  uint64_t state = 0x6a09e667f3bcc908;
+
+  for (size_t i = 0; i < table.size(); i++) {
+    state += 0x9e3779b97f4a7c15;
+
+    uint64_t value = state;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+
+    table[i] = value ^ (value >> 31);
+  }
+
+  return table;
+}
+
+static constexpr std::array<uint64_t, 256> GEAR_TABLE = CreateGearTable();
+
+// The fingerprint is shifted left, so its high bits depend on more bytes.
+static uint64_t HighBitsMask(uint32_t bitCount) {
+  return ~(uint64_t)0 << (64 - bitCount);
+}
+
+bool FixedSizeChunker::FindBoundary(const uint8_t* data, size_t length,
+                                    size_t& chunkEnd) {
+  size_t rest = _chunkSize - _filled;
+
+  if (length < rest) {
+    _filled += length;
+
+    return false;
+  }
+
+  chunkEnd = rest;
+  _filled = 0;
+
+  return true;
+}
+
+GearChunker::GearChunker(size_t minChunkSize, size_t avgChunkSize,
+                         size_t maxChunkSize)
+    : _minChunkSize(minChunkSize),
+      _avgChunkSize(avgChunkSize),
+      _maxChunkSize(maxChunkSize) {
+  uint32_t bitCount = 0;
+
+  while (((size_t)2 << bitCount) <= avgChunkSize) {
+    bitCount++;
+  }
+
+  // Normalization level 2.
+  _strictMask = HighBitsMask(bitCount + 2);
+  _looseMask = HighBitsMask(bitCount - 2);
+}
+
+bool GearChunker::FindBoundary(const uint8_t* data, size_t length,
+                               size_t& chunkEnd) {
+  size_t base = _position;
+
+  auto endOf = [&](size_t chunkSize) {
+    return chunkSize > base ? std::min(length, chunkSize - base) : 0;
+  };
+
+  size_t minEnd = endOf(_minChunkSize);
+  size_t avgEnd = endOf(_avgChunkSize);
+  size_t maxEnd = endOf(_maxChunkSize);
+
+  uint64_t fingerprint = _fingerprint;
+  size_t i = minEnd;
+
+  for (; i < avgEnd; i++) {
+    fingerprint = (fingerprint << 1) + GEAR_TABLE[data[i]];
+
+    if ((fingerprint & _strictMask) == 0) {
+      break;
+    }
+  }
+
+  if (i == avgEnd) {
+    for (; i < maxEnd; i++) {
+      fingerprint = (fingerprint << 1) + GEAR_TABLE[data[i]];
+
+      if ((fingerprint & _looseMask) == 0) {
+        break;
+      }
+    }
+  }
+
+  if (i < maxEnd) {
+    chunkEnd = i + 1;
+  } else if (base + maxEnd == _maxChunkSize) {
+    chunkEnd = maxEnd;
+  } else {
+    _position = base + length;
+    _fingerprint = fingerprint;
+
+    return false;
+  }
+
+  _position = 0;
+  _fingerprint = 0;
+
+  return true;
+}
+
+std::unique_ptr<Chunker> CreateChunker(const ChunkingOptions& options) {
+  if (options.mode == ChunkingMode::ContentDefined) {
+    return std::make_unique<GearChunker>(
+        options.minChunkSize, options.chunkSize, options.maxChunkSize);
+  }
+
+  return std::make_unique<FixedSizeChunker>(options.chunkSize);
+}
+
+void ChunkHasher::Update(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    size_t chunkEnd;
+
+    if (!_chunker.FindBoundary(data, length, chunkEnd)) {
+      if (_chunkLength == 0) {
+        _state.Reset(_key);
+      }
+
+      _state.Update(data, length);
+      _chunkLength += length;
+
+      return;
+    }
+
+    GenericHashResult hash;
+
+    if (_chunkLength == 0) {
+      // The whole chunk is in the data, no need to stream it.
+      hash = XxHashDynamicState::Oneshot(_variant, data, chunkEnd, _key);
+    } else {
+      _state.Update(data, chunkEnd);
+      hash = _state.GetResult();
+    }
+
+    AddChunk(_chunkLength + chunkEnd, hash);
+
+    data += chunkEnd;
+    length -= chunkEnd;
+  }
+}
+
+ChunkList ChunkHasher::Finish() {
+  if (_chunkLength > 0) {
+    AddChunk(_chunkLength, _state.GetResult());
+  }
+
+  return std::move(_chunks);
+}
+
+void ChunkHasher::AddChunk(uint64_t length, GenericHashResult hash) {
+  _chunks.offsets.push_back(_chunkOffset);
+  _chunks.lengths.push_back(length);
+  _chunks.hashes.push_back(hash);
+
+  _chunkOffset += length;
+  _chunkLength = 0;
+}
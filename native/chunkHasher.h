@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "hashers.h"
+
+// Splits a stream of data into chunks.
+class Chunker {
+ public:
+  virtual ~Chunker() {}
+
+  // Called with the data that follows the already consumed part of the
+  // current chunk. Returns true and sets chunkEnd to the number of leading
+  // bytes of data that complete the chunk (at least 1) if the chunk ends
+  // within data; the next call starts a new chunk. Otherwise all the data
+  // belongs to the current chunk.
+  virtual bool FindBoundary(const uint8_t* data, size_t length,
+                            size_t& chunkEnd) = 0;
+};
+
+class FixedSizeChunker : public Chunker {
+ public:
+  FixedSizeChunker(size_t chunkSize) : _chunkSize(chunkSize) {}
+
+  bool FindBoundary(const uint8_t* data, size_t length,
+                    size_t& chunkEnd) override;
+
+ private:
+  size_t _chunkSize;
+  size_t _filled = 0;
+};
+
+// Content-defined chunking with a Gear rolling hash and FastCDC's normalized
+// chunking: no boundaries are looked for in the first minChunkSize bytes of a
+// chunk, a stricter mask is used until avgChunkSize and a looser one after it,
+// and the chunk is cut at maxChunkSize. Inserting or removing data only
+// changes the chunks around the edit.
+//
+// The gear table is fixed, so the boundaries are stable between versions and
+// platforms.
+class GearChunker : public Chunker {
+ public:
+  // avgChunkSize should be at least MIN_AVG_CHUNK_SIZE and
+  // minChunkSize <= avgChunkSize <= maxChunkSize.
+  GearChunker(size_t minChunkSize, size_t avgChunkSize, size_t maxChunkSize);
+
+  bool FindBoundary(const uint8_t* data, size_t length,
+                    size_t& chunkEnd) override;
+
+  static constexpr size_t MIN_AVG_CHUNK_SIZE = 64;
+
+ private:
+  size_t _minChunkSize;
+  size_t _avgChunkSize;
+  size_t _maxChunkSize;
+  uint64_t _strictMask;
+  uint64_t _looseMask;
+
+  size_t _position = 0;
+  uint64_t _fingerprint = 0;
+};
+
+enum class ChunkingMode { Fixed, ContentDefined };
+
+struct ChunkingOptions {
+  ChunkingMode mode;
+
+  // The size of the chunks in the fixed mode, the average one otherwise.
+  size_t chunkSize;
+  size_t minChunkSize;
+  size_t maxChunkSize;
+};
+
+std::unique_ptr<Chunker> CreateChunker(const ChunkingOptions& options);
+
+struct ChunkList {
+  std::vector<uint64_t> offsets;
+  std::vector<uint64_t> lengths;
+  std::vector<GenericHashResult> hashes;
+};
+
+// Hashes each chunk of the stream in the same pass the chunks are found.
+class ChunkHasher {
+ public:
+  // startOffset is the offset of the first byte of the stream, it's added to
+  // the offsets of the chunks.
+  ChunkHasher(uint32_t variant, HashKey key, Chunker& chunker,
+              uint64_t startOffset = 0)
+      : _variant(variant),
+        _key(key),
+        _chunker(chunker),
+        _state(variant),
+        _chunkOffset(startOffset) {}
+
+  void Update(const uint8_t* data, size_t length);
+
+  // Adds the last chunk, if it's not empty, and returns all the chunks.
+  ChunkList Finish();
+
+ private:
+  uint32_t _variant;
+  HashKey _key;
+  Chunker& _chunker;
+  XxHashDynamicState _state;
+
+  uint64_t _chunkOffset;
+  uint64_t _chunkLength = 0;
+  ChunkList _chunks;
+
+  void AddChunk(uint64_t length, GenericHashResult hash);
+};
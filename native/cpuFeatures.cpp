@@ -0,0 +1,18 @@
+#include "index.h"
+#include "xxhashDispatch.h"
+
+Napi::Value XxHashAddon::GetCpuFeatures(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  unsigned features = XXH_cpuFeatures();
+
+  auto result = Napi::Object::New(env);
+  result.Set("sse2", Napi::Boolean::New(env, features & XXH_CPU_SSE2));
+  result.Set("avx2", Napi::Boolean::New(env, features & XXH_CPU_AVX2));
+  result.Set("avx512", Napi::Boolean::New(env, features & XXH_CPU_AVX512));
+
+  return result;
+}
+
+Napi::Value XxHashAddon::GetActiveVectorPath(const Napi::CallbackInfo& info) {
+  return Napi::String::New(info.Env(), XXH_activeVectorPath());
+}
@@ -8,5 +8,18 @@ Napi::Value XxHashAddon::CreateHashState(const Napi::CallbackInfo& info) {
   auto env = info.Env();
   auto data = (CreateStateData*)info.Data();
 
-  return data->constructor->New({Napi::Number::New(env, data->variant), info[0]});
+  return data->constructor->New({info[0]});
+}
+
+Napi::Value XxHashAddon::CreateHashStateFromSerialized(
+    const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  auto data = (CreateStateData*)info.Data();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  return JsHashStateObject::FromSerialized(env, data->constructor,
+                                           data->variant, info[0]);
 }
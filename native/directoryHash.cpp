@@ -0,0 +1,147 @@
+#include <napi.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "fileHashWorker.h"
+#include "hashers.h"
+#include "index.h"
+#include "jsObjectParser.h"
+#include "jsUtils.h"
+#include "platform/directory.h"
+#include "platform/nativeString.h"
+#include "platform/platformError.h"
+
+DirectoryHashRequest JsParseDirectoryHashOptions(Napi::Env env,
+                                                 uint32_t variant,
+                                                 Napi::Object options) {
+  auto path = JsParseProperty<Napi::String>(env, options, "path");
+  // The request may outlive the options, so it gets a copy of the secret.
+  HashKey key = JsParseHashKeyProperty(env, variant, options).Own();
+  auto preferMap = JsParseProperty<bool>(env, options, "preferMap", false);
+  auto recursive = JsParseProperty<bool>(env, options, "recursive", true);
+  auto followSymlinks =
+      JsParseProperty<bool>(env, options, "followSymlinks", false);
+  auto blockSize = JsParseBlockSizeProperty(env, options);
+  auto accessPattern = JsParseProperty<AccessPattern>(
+      env, options, "accessPattern", AccessPattern::Sequential);
+  auto concurrency = JsParseProperty<uint32_t>(env, options, "concurrency", 0);
+
+  auto nativePath = JsStringToCString<NativeChar>(path);
+
+  return {nativePath, {recursive, followSymlinks}, key, preferMap, blockSize,
+          accessPattern, concurrency};
+}
+
+// Returns [paths, hashes] - the map itself is built on JS side.
+Napi::Value JsParseDirectoryHashResult(Napi::Env env, uint32_t variant,
+                                       const DirectoryHashResult& result) {
+  size_t count = result.paths.size();
+
+  auto jsPaths = Napi::Array::New(env, count);
+  auto jsHashes = Napi::Array::New(env, count);
+
+  for (uint32_t i = 0; i < count; i++) {
+    jsPaths.Set(i, CStringToJsString(env, result.paths[i]));
+    jsHashes.Set(i, JsParseHashResult(env, variant, result.hashes[i]));
+  }
+
+  auto jsResult = Napi::Array::New(env, 2);
+  jsResult.Set(0u, jsPaths);
+  jsResult.Set(1u, jsHashes);
+
+  return jsResult;
+}
+
+Napi::Value XxHashAddon::DirectoryHash(const Napi::CallbackInfo& info) {
+  uint32_t variant = GetVariantData(info);
+  auto env = info.Env();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  try {
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseDirectoryHashOptions(env, variant, options);
+
+    auto result = HashDirectory(request, variant);
+
+    return JsParseDirectoryHashResult(env, variant, result);
+  } catch (const PlatformException& exc) {
+    Napi::Error::New(env, exc.WhatJs(env)).ThrowAsJavaScriptException();
+
+    return env.Undefined();
+  }
+}
+
+Napi::Value XxHashAddon::DirectoryHashAsync(const Napi::CallbackInfo& info) {
+  class DirectoryWorker : public Napi::AsyncWorker {
+   public:
+    DirectoryWorker(uint32_t variant, DirectoryHashRequest request,
+                    Napi::Function callback)
+        : Napi::AsyncWorker(callback), _variant(variant), _request(request) {}
+
+    void Execute() {
+      try {
+        _result = HashDirectory(_request, _variant);
+      } catch (PlatformException& exc) {
+        _error = exc.ErrorCode();
+      } catch (std::exception& exc) {
+        _errorMessage = exc.what();
+      }
+    }
+
+    void OnOK() {
+      auto env = Env();
+
+      if (_error != 0) {
+        auto jsErrorMessage =
+            PlatformException::FormatErrorToJsString(env, _error);
+        auto jsError = Napi::Error::New(env, jsErrorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else if (!_errorMessage.empty()) {
+        auto jsError = Napi::Error::New(env, _errorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else {
+        auto jsResult = JsParseDirectoryHashResult(env, _variant, _result);
+
+        Callback().Call({env.Undefined(), jsResult});
+      }
+    }
+
+   private:
+    uint32_t _variant;
+    DirectoryHashRequest _request;
+
+    DirectoryHashResult _result;
+    ErrorDesc _error = 0;
+    std::string _errorMessage;
+  };
+
+  uint32_t variant = GetVariantData(info);
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  Napi::Function callback;
+  try {
+    callback = JsParseArgument<Napi::Function>(env, info[1], "callback");
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseDirectoryHashOptions(env, variant, options);
+
+    DirectoryWorker* worker = new DirectoryWorker(variant, request, callback);
+    worker->Queue();
+  } catch (const PlatformException& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback, exc.WhatJs(env));
+  } catch (const std::exception& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback,
+                                    Napi::String::New(env, exc.what()));
+  }
+
+  return env.Undefined();
+}
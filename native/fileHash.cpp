@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 #include "fileHashWorker.h"
 #include "hashers.h"
@@ -13,6 +14,56 @@
 
 #undef max
 
+FileHashRequest JsParseFileHashOptions(Napi::Env env, uint32_t variant,
+                                       Napi::Object options) {
+  auto path = JsParseProperty<Napi::String>(env, options, "path");
+  // The request may outlive the options, so it gets a copy of the secret.
+  HashKey key = JsParseHashKeyProperty(env, variant, options).Own();
+  auto preferMap = JsParseProperty<bool>(env, options, "preferMap", false);
+  auto offset = JsParseProperty<uint64_t>(env, options, "offset", 0);
+  auto length = JsParseProperty<uint64_t>(env, options, "length", std::numeric_limits<uint64_t>::max());
+  auto blockSize = JsParseBlockSizeProperty(env, options);
+
+  auto readAhead = ReadAheadMode::Auto;
+  if (!options.Get("readAhead").IsUndefined()) {
+    readAhead = JsParseProperty<bool>(env, options, "readAhead", false)
+                    ? ReadAheadMode::Always
+                    : ReadAheadMode::Never;
+  }
+
+  auto accessPattern = JsParseProperty<AccessPattern>(
+      env, options, "accessPattern", AccessPattern::Sequential);
+
+  auto nativePath = JsStringToCString<NativeChar>(path);
+
+  return {{nativePath, offset, length, blockSize, readAhead, accessPattern},
+          key,
+          preferMap};
+}
+
+FileTreeHashRequest JsParseFileTreeHashOptions(Napi::Env env, uint32_t variant,
+                                               Napi::Object options) {
+  auto file = JsParseFileHashOptions(env, variant, options);
+  auto chunkSize = JsParseProperty<uint64_t>(env, options, "chunkSize",
+                                             TREE_DEFAULT_CHUNK_SIZE);
+  auto concurrency = JsParseProperty<uint32_t>(env, options, "concurrency", 0);
+
+  if (chunkSize == 0) {
+    JsValueParseContext(env, "chunkSize", "property")
+        .InvalidValue("a positive integer");
+  }
+
+  return {file, (size_t)chunkSize, concurrency};
+}
+
+FileChunksRequest JsParseFileChunksOptions(Napi::Env env, uint32_t variant,
+                                           Napi::Object options) {
+  auto file = JsParseFileHashOptions(env, variant, options);
+  auto chunking = JsParseChunkingOptions(env, options);
+
+  return {file, chunking};
+}
+
 Napi::Value XxHashAddon::FileHash(const Napi::CallbackInfo& info) {
   uint32_t variant = GetVariantData(info);
   auto env = info.Env();
@@ -23,17 +74,9 @@ Napi::Value XxHashAddon::FileHash(const Napi::CallbackInfo& info) {
 
   try {
     auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileHashOptions(env, variant, options);
 
-    auto path = JsParseProperty<Napi::String>(env, options, "path");
-    uint64_t seed = JsParseSeedProperty(env, variant, options);
-    auto preferMap = JsParseProperty<bool>(env, options, "preferMap", false);
-    auto offset = JsParseProperty<uint64_t>(env, options, "offset", 0);
-    auto length = JsParseProperty<uint64_t>(env, options, "length", std::numeric_limits<uint64_t>::max());
-
-    auto nativePath = JsStringToCString<NativeChar>(path);
-    HashWorkerContext hashContext(nativePath, offset, length);
-
-    auto result = HashFile(hashContext, variant, seed, preferMap);
+    auto result = HashFile(request, variant);
 
     return JsParseHashResult(env, variant, result);
   } catch (const PlatformException& exc) {
@@ -43,37 +86,42 @@ Napi::Value XxHashAddon::FileHash(const Napi::CallbackInfo& info) {
   }
 }
 
-void ExecuteCallbackWithErrorOrThrow(Napi::Env env,
-                                     const Napi::Function& callback,
-                                     const Napi::String& message) {
-  auto error = Napi::Error::New(env, message);
+Napi::Value XxHashAddon::FileHashInto(const Napi::CallbackInfo& info) {
+  uint32_t variant = GetVariantData(info);
+  auto env = info.Env();
 
-  if (callback.IsUndefined()) {
-    error.ThrowAsJavaScriptException();
-  } else {
-    callback.Call({error.Value()});
+  // (options, out, offset?)
+  if (info.Length() < 2 || info.Length() > 3) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
   }
+
+  try {
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileHashOptions(env, variant, options);
+
+    // Validate out before doing any I/O.
+    uint8_t* destination =
+        JsParseHashResultDestination(env, variant, info[1], info[2]);
+
+    auto result = HashFile(request, variant);
+    StoreHashResult(variant, result, destination);
+  } catch (const PlatformException& exc) {
+    Napi::Error::New(env, exc.WhatJs(env)).ThrowAsJavaScriptException();
+  }
+
+  return env.Undefined();
 }
 
 Napi::Value XxHashAddon::FileHashAsync(const Napi::CallbackInfo& info) {
   class ReaderWorker : public Napi::AsyncWorker {
    public:
-    ReaderWorker(uint32_t variant, uint64_t seed, NativeString path,
-                 size_t fileOffset, size_t length, bool preferMap,
+    ReaderWorker(uint32_t variant, FileHashRequest request,
                  Napi::Function callback)
-        : Napi::AsyncWorker(callback),
-          _variant(variant),
-          _seed(seed),
-          _path(path),
-          _fileOffset(fileOffset),
-          _preferMap(preferMap),
-          _length(length) {}
+        : Napi::AsyncWorker(callback), _variant(variant), _request(request) {}
 
     void Execute() {
-      HashWorkerContext hashContext(_path, _fileOffset, _length);
-
       try {
-        _result = HashFile(hashContext, _variant, _seed, _preferMap);
+        _result = HashFile(_request, _variant);
       } catch (PlatformException& exc) {
         _error = exc.ErrorCode();
       }
@@ -97,14 +145,205 @@ Napi::Value XxHashAddon::FileHashAsync(const Napi::CallbackInfo& info) {
 
    private:
     uint32_t _variant;
-    NativeString _path;
-    size_t _fileOffset;
-    size_t _length;
-    uint64_t _seed;
-    bool _preferMap;
+    FileHashRequest _request;
+
+    GenericHashResult _result;
+    ErrorDesc _error = 0;
+  };
+
+  uint32_t variant = GetVariantData(info);
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  Napi::Function callback;
+  try {
+    callback = JsParseArgument<Napi::Function>(env, info[1], "callback");
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileHashOptions(env, variant, options);
+
+    ReaderWorker* worker = new ReaderWorker(variant, request, callback);
+    worker->Queue();
+  } catch (const PlatformException& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback, exc.WhatJs(env));
+  } catch (const std::exception& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback,
+                                    Napi::String::New(env, exc.what()));
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value XxHashAddon::FilesHashAsync(const Napi::CallbackInfo& info) {
+  class BatchWorker : public Napi::AsyncWorker {
+   public:
+    BatchWorker(uint32_t variant, std::vector<FileHashRequest> requests,
+                uint32_t concurrency, bool useIoUring, Napi::Function callback)
+        : Napi::AsyncWorker(callback),
+          _variant(variant),
+          _concurrency(concurrency),
+          _useIoUring(useIoUring),
+          _requests(std::move(requests)) {}
+
+    void Execute() {
+      try {
+        _results =
+            HashFiles(_requests, _variant, _concurrency, _useIoUring);
+      } catch (PlatformException& exc) {
+        _error = exc.ErrorCode();
+      } catch (std::exception& exc) {
+        _errorMessage = exc.what();
+      }
+    }
+
+    void OnOK() {
+      auto env = Env();
+
+      if (_error != 0) {
+        auto jsErrorMessage =
+            PlatformException::FormatErrorToJsString(env, _error);
+        auto jsError = Napi::Error::New(env, jsErrorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else if (!_errorMessage.empty()) {
+        auto jsError = Napi::Error::New(env, _errorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else {
+        auto jsResults = Napi::Array::New(env, _results.size());
+
+        for (uint32_t i = 0; i < _results.size(); i++) {
+          jsResults.Set(i, JsParseHashResult(env, _variant, _results[i]));
+        }
+
+        Callback().Call({env.Undefined(), jsResults});
+      }
+    }
+
+   private:
+    uint32_t _variant;
+    uint32_t _concurrency;
+    bool _useIoUring;
+    std::vector<FileHashRequest> _requests;
+
+    std::vector<GenericHashResult> _results;
+    ErrorDesc _error = 0;
+    std::string _errorMessage;
+  };
+
+  uint32_t variant = GetVariantData(info);
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 3) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  Napi::Function callback;
+  try {
+    callback = JsParseArgument<Napi::Function>(env, info[2], "callback");
+    auto options = JsParseArgument<Napi::Array>(env, info[0], "options");
+    uint32_t concurrency = 0;
+    bool useIoUring = true;
+
+    if (!info[1].IsUndefined()) {
+      auto batchOptions =
+          JsParseArgument<Napi::Object>(env, info[1], "batchOptions");
+
+      concurrency =
+          JsParseProperty<uint32_t>(env, batchOptions, "concurrency", 0);
+      useIoUring = JsParseProperty<bool>(env, batchOptions, "ioUring", true);
+    }
+
+    std::vector<FileHashRequest> requests;
+    requests.reserve(options.Length());
+
+    for (uint32_t i = 0; i < options.Length(); i++) {
+      auto fileOptions = JsParseArgument<Napi::Object>(env, options.Get(i), "options");
+
+      requests.push_back(JsParseFileHashOptions(env, variant, fileOptions));
+    }
+
+    BatchWorker* worker = new BatchWorker(variant, std::move(requests),
+                                          concurrency, useIoUring, callback);
+    worker->Queue();
+  } catch (const PlatformException& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback, exc.WhatJs(env));
+  } catch (const std::exception& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback,
+                                    Napi::String::New(env, exc.what()));
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value XxHashAddon::FileTreeHash(const Napi::CallbackInfo& info) {
+  uint32_t variant = GetVariantData(info);
+  auto env = info.Env();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  try {
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileTreeHashOptions(env, variant, options);
+
+    auto result = HashFileTree(request, variant);
+
+    return JsParseHashResult(env, variant, result);
+  } catch (const PlatformException& exc) {
+    Napi::Error::New(env, exc.WhatJs(env)).ThrowAsJavaScriptException();
+
+    return env.Undefined();
+  }
+}
+
+Napi::Value XxHashAddon::FileTreeHashAsync(const Napi::CallbackInfo& info) {
+  class TreeWorker : public Napi::AsyncWorker {
+   public:
+    TreeWorker(uint32_t variant, FileTreeHashRequest request,
+               Napi::Function callback)
+        : Napi::AsyncWorker(callback), _variant(variant), _request(request) {}
+
+    void Execute() {
+      try {
+        _result = HashFileTree(_request, _variant);
+      } catch (PlatformException& exc) {
+        _error = exc.ErrorCode();
+      } catch (std::exception& exc) {
+        _errorMessage = exc.what();
+      }
+    }
+
+    void OnOK() {
+      auto env = Env();
+
+      if (_error != 0) {
+        auto jsErrorMessage =
+            PlatformException::FormatErrorToJsString(env, _error);
+        auto jsError = Napi::Error::New(env, jsErrorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else if (!_errorMessage.empty()) {
+        auto jsError = Napi::Error::New(env, _errorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else {
+        auto jsResult = JsParseHashResult(env, _variant, _result);
+
+        Callback().Call({env.Undefined(), jsResult});
+      }
+    }
+
+   private:
+    uint32_t _variant;
+    FileTreeHashRequest _request;
 
     GenericHashResult _result;
     ErrorDesc _error = 0;
+    std::string _errorMessage;
   };
 
   uint32_t variant = GetVariantData(info);
@@ -118,17 +357,102 @@ Napi::Value XxHashAddon::FileHashAsync(const Napi::CallbackInfo& info) {
   try {
     callback = JsParseArgument<Napi::Function>(env, info[1], "callback");
     auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileTreeHashOptions(env, variant, options);
+
+    TreeWorker* worker = new TreeWorker(variant, request, callback);
+    worker->Queue();
+  } catch (const PlatformException& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback, exc.WhatJs(env));
+  } catch (const std::exception& exc) {
+    ExecuteCallbackWithErrorOrThrow(env, callback,
+                                    Napi::String::New(env, exc.what()));
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value XxHashAddon::FileChunksHash(const Napi::CallbackInfo& info) {
+  uint32_t variant = GetVariantData(info);
+  auto env = info.Env();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  try {
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileChunksOptions(env, variant, options);
+
+    auto chunks = HashFileChunks(request, variant);
+
+    return JsCreateChunkList(env, variant, chunks);
+  } catch (const PlatformException& exc) {
+    Napi::Error::New(env, exc.WhatJs(env)).ThrowAsJavaScriptException();
+
+    return env.Undefined();
+  }
+}
+
+Napi::Value XxHashAddon::FileChunksHashAsync(const Napi::CallbackInfo& info) {
+  class ChunksWorker : public Napi::AsyncWorker {
+   public:
+    ChunksWorker(uint32_t variant, FileChunksRequest request,
+                 Napi::Function callback)
+        : Napi::AsyncWorker(callback), _variant(variant), _request(request) {}
+
+    void Execute() {
+      try {
+        _chunks = HashFileChunks(_request, _variant);
+      } catch (PlatformException& exc) {
+        _error = exc.ErrorCode();
+      } catch (std::exception& exc) {
+        _errorMessage = exc.what();
+      }
+    }
+
+    void OnOK() {
+      auto env = Env();
 
-    auto path = JsParseProperty<Napi::String>(env, options, "path");
-    uint64_t seed = JsParseSeedProperty(env, variant, options);
-    auto preferMap = JsParseProperty<bool>(env, options, "preferMap", false);
-    auto offset = JsParseProperty<uint64_t>(env, options, "offset", 0);
-    auto length = JsParseProperty<uint64_t>(env, options, "length", std::numeric_limits<uint64_t>::max());
+      if (_error != 0) {
+        auto jsErrorMessage =
+            PlatformException::FormatErrorToJsString(env, _error);
+        auto jsError = Napi::Error::New(env, jsErrorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else if (!_errorMessage.empty()) {
+        auto jsError = Napi::Error::New(env, _errorMessage).Value();
+
+        Callback().Call({jsError, env.Undefined()});
+      } else {
+        auto jsResult = JsCreateChunkList(env, _variant, _chunks);
+
+        Callback().Call({env.Undefined(), jsResult});
+      }
+    }
+
+   private:
+    uint32_t _variant;
+    FileChunksRequest _request;
+
+    ChunkList _chunks;
+    ErrorDesc _error = 0;
+    std::string _errorMessage;
+  };
+
+  uint32_t variant = GetVariantData(info);
+  Napi::Env env = info.Env();
+
+  if (info.Length() != 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  Napi::Function callback;
+  try {
+    callback = JsParseArgument<Napi::Function>(env, info[1], "callback");
+    auto options = JsParseArgument<Napi::Object>(env, info[0], "options");
+    auto request = JsParseFileChunksOptions(env, variant, options);
 
-    auto nativePath = JsStringToCString<NativeChar>(path);
-    
-    ReaderWorker* worker = new ReaderWorker(variant, seed, nativePath, offset,
-                                            length, preferMap, callback);
+    ChunksWorker* worker = new ChunksWorker(variant, request, callback);
     worker->Queue();
   } catch (const PlatformException& exc) {
     ExecuteCallbackWithErrorOrThrow(env, callback, exc.WhatJs(env));
@@ -1,10 +1,30 @@
 #include "fileHashWorker.h"
 
-GenericHashResult BlockHashWorker::Process(const HashWorkerContext& context) {
-  _blockReader.Open(context.path, context.offset, context.length);
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "parallel.h"
+#include "platform/ioUring.h"
+
+#undef min
+#undef max
+
+static bool ShouldReadAhead(ReadAheadMode mode, size_t expectedLength) {
+  switch (mode) {
+    case ReadAheadMode::Always:
+      return true;
+    case ReadAheadMode::Auto:
+      return expectedLength >= READ_AHEAD_MIN_LENGTH;
+    default:
+      return false;
+  }
+}
 
+template <typename Reader>
+void BlockHashWorker::HashBlocks(Reader& reader) {
   while (true) {
-    auto block = _blockReader.ReadBlock();
+    auto block = reader.ReadBlock();
 
     if (block.length == 0) {
       break;
@@ -12,13 +32,29 @@ GenericHashResult BlockHashWorker::Process(const HashWorkerContext& context) {
 
     _state.Update(block.data, block.length);
   }
+}
+
+GenericHashResult BlockHashWorker::Process(const HashWorkerContext& context) {
+  _blockReader.Open(context.path, context.offset, context.length,
+                    context.blockSize, context.accessPattern);
+  _state.Reset(_key);
+
+  bool readAhead =
+      ShouldReadAhead(context.readAhead, _blockReader.GetExpectedLength());
+
+  if (readAhead && _readAheadReader.Start(_blockReader)) {
+    HashBlocks(_readAheadReader);
+  } else {
+    HashBlocks(_blockReader);
+  }
 
   return _state.GetResult();
 }
 
 GenericHashResult MapHashWorker::Process(const HashWorkerContext& context) {
   MemoryMappedFile file;
-  bool isCompatible = file.Open(context.path, context.offset, context.length);
+  bool isCompatible = file.Open(context.path, context.offset, context.length,
+                                context.accessPattern);
 
   if (!isCompatible) {
     // Based on the assumption that the incompatible file is a pretty rare
@@ -26,19 +62,331 @@ GenericHashResult MapHashWorker::Process(const HashWorkerContext& context) {
     // inside a MapHashWorker.
     //
     // Use a oneshot method.
-    return _HashFile<BlockHashWorker>(context, _variant, _seed);
+    return _HashFile<BlockHashWorker>(context, _variant, _key);
   }
 
-  size_t size = file.GetSize();
-  GenericHashResult result;
+  // The file was truncated or the storage failed while it was being read.
+  auto onError = [] {
+    throw PlatformException(MemoryMappedFile::ACCESS_ERROR);
+  };
+
+  if (file.GetSize() <= MemoryMappedFile::GetWindowSize()) {
+    // The range is mapped at once.
+    GenericHashResult result;
+
+    file.Access(
+        [&](const uint8_t* address, size_t length) {
+          result = XxHashDynamicState::Oneshot(_variant, address, length, _key);
+        },
+        onError);
+
+    return result;
+  }
+
+  _state.Reset(_key);
 
   file.Access(
-      [&](const uint8_t* address) {
-        result = XxHashDynamicState::Oneshot(_variant, address, size, _seed);
+      [&](const uint8_t* address, size_t length) {
+        _state.Update(address, length);
       },
-      [&] {
-        throw std::runtime_error("IO error occurred while reading the file");
-      });
+      onError);
+
+  return _state.GetResult();
+}
+
+namespace {
+
+// Per-thread worker of HashFiles(). Files read block by block are read with
+// io_uring when it's available, with the regular BlockHashWorker otherwise.
+class BatchHashWorker : public IoUringBatchReader {
+ public:
+  BatchHashWorker(uint32_t variant, const std::vector<FileHashRequest>& requests,
+                  std::vector<GenericHashResult>& results, ParallelQueue& queue)
+      : _variant(variant),
+        _requests(requests),
+        _results(results),
+        _queue(queue),
+        _blockWorker(variant, 0),
+        _mapWorker(variant, 0) {}
+
+  void Run(bool useIoUring) {
+    if (useIoUring && Init()) {
+      _slots.reserve(MAX_OPEN_FILES);
+
+      for (uint32_t i = 0; i < MAX_OPEN_FILES; i++) {
+        _slots.emplace_back(_variant);
+      }
+
+      IoUringBatchReader::Run();
+      return;
+    }
+
+    size_t index;
+    while (_queue.Next(index)) {
+      auto& request = _requests[index];
+
+      if (request.preferMap) {
+        HashMapped(index);
+      } else {
+        _blockWorker.SetKey(request.key);
+        _results[index] = _blockWorker.Process(request.context);
+      }
+    }
+  }
+
+ protected:
+  bool NextFile(uint32_t slot, IoUringFileRequest& fileRequest) override {
+    size_t index;
+
+    while (_queue.Next(index)) {
+      auto& request = _requests[index];
+
+      if (request.preferMap) {
+        HashMapped(index);
+        continue;
+      }
+
+      auto& context = request.context;
+
+      _slots[slot].index = index;
+      _slots[slot].state.Reset(request.key);
+
+      fileRequest = {&context.path, context.offset, context.length,
+                     context.blockSize, context.accessPattern};
+
+      return true;
+    }
+
+    return false;
+  }
+
+  void OnBlock(uint32_t slot, const uint8_t* data, size_t length) override {
+    _slots[slot].state.Update(data, length);
+  }
+
+  void OnEnd(uint32_t slot) override {
+    _results[_slots[slot].index] = _slots[slot].state.GetResult();
+  }
+
+ private:
+  struct FileState {
+    size_t index = 0;
+    XxHashDynamicState state;
+
+    FileState(uint32_t variant) : state(variant) {}
+  };
+
+  uint32_t _variant;
+  const std::vector<FileHashRequest>& _requests;
+  std::vector<GenericHashResult>& _results;
+  ParallelQueue& _queue;
+
+  BlockHashWorker _blockWorker;
+  MapHashWorker _mapWorker;
+  std::vector<FileState> _slots;
+
+  void HashMapped(size_t index) {
+    auto& request = _requests[index];
+
+    _mapWorker.SetKey(request.key);
+    _results[index] = _mapWorker.Process(request.context);
+  }
+};
+
+}  // namespace
+
+std::vector<GenericHashResult> HashFiles(
+    const std::vector<FileHashRequest>& requests, uint32_t variant,
+    uint32_t concurrency, bool useIoUring) {
+  std::vector<GenericHashResult> results(requests.size());
+  uint32_t threadCount = ResolveConcurrency(concurrency, requests.size());
+  ParallelQueue queue(requests.size());
+
+  ParallelRun(threadCount, [&]() {
+    try {
+      BatchHashWorker worker(variant, requests, results, queue);
+
+      worker.Run(useIoUring);
+    } catch (...) {
+      queue.Fail();
+      throw;
+    }
+  });
+
+  return results;
+}
+
+static void StoreBigEndian64(uint8_t* destination, uint64_t value) {
+  for (int i = 7; i >= 0; i--) {
+    destination[i] = (uint8_t)value;
+    value >>= 8;
+  }
+}
+
+GenericHashResult HashFileTree(const FileTreeHashRequest& request,
+                               uint32_t variant) {
+  const auto& context = request.file.context;
+  const HashKey& key = request.file.key;
+  size_t chunkSize = request.chunkSize;
+  size_t resultSize = GetHashResultSize(variant);
+
+  BlockReader reader;
+  reader.Open(context.path, context.offset, context.length, context.blockSize,
+              context.accessPattern);
+
+  std::vector<uint8_t> digests;
+  size_t length = 0;
+
+  if (reader.IsRegularFile()) {
+    length = reader.GetExpectedLength();
+
+    size_t chunkCount = length / chunkSize + (length % chunkSize != 0 ? 1 : 0);
+    digests.resize(chunkCount * resultSize);
+
+    auto createWorker = [&]() -> std::unique_ptr<HashWorker> {
+      if (request.file.preferMap) {
+        return std::make_unique<MapHashWorker>(variant, key);
+      }
+
+      return std::make_unique<BlockHashWorker>(variant, key);
+    };
+
+    // Chunks are read in parallel, so there's no need to read ahead.
+    ParallelFor(chunkCount, ResolveConcurrency(request.concurrency, chunkCount),
+                createWorker,
+                [&](std::unique_ptr<HashWorker>& worker, size_t index) {
+                  size_t chunkOffset = index * chunkSize;
+                  HashWorkerContext chunk(
+                      context.path, context.offset + chunkOffset,
+                      std::min(chunkSize, length - chunkOffset),
+                      context.blockSize, ReadAheadMode::Never,
+                      context.accessPattern);
+
+                  StoreCanonicalHashResult(variant, worker->Process(chunk),
+                                           &digests[index * resultSize]);
+                });
+  } else {
+    // The length of a pipe or a device isn't known in advance, so the chunks
+    // are split off as the data comes.
+    XxHashDynamicState state(variant);
+    state.Reset(key);
+
+    size_t chunkFilled = 0;
+
+    auto finishChunk = [&]() {
+      size_t position = digests.size();
+      digests.resize(position + resultSize);
+
+      StoreCanonicalHashResult(variant, state.GetResult(), &digests[position]);
+      state.Reset(key);
+      chunkFilled = 0;
+    };
+
+    while (true) {
+      auto block = reader.ReadBlock();
+
+      if (block.length == 0) {
+        break;
+      }
+
+      length += block.length;
+
+      for (size_t consumed = 0; consumed < block.length;) {
+        size_t part = std::min(block.length - consumed, chunkSize - chunkFilled);
+
+        state.Update(block.data + consumed, part);
+        consumed += part;
+        chunkFilled += part;
+
+        if (chunkFilled == chunkSize) {
+          finishChunk();
+        }
+      }
+    }
+
+    if (chunkFilled > 0) {
+      finishChunk();
+    }
+  }
+
+  size_t position = digests.size();
+  digests.resize(position + 2 * sizeof(uint64_t));
+
+  StoreBigEndian64(&digests[position], chunkSize);
+  StoreBigEndian64(&digests[position + sizeof(uint64_t)], length);
+
+  return XxHashDynamicState::Oneshot(variant, digests.data(), digests.size(),
+                                     key);
+}
+
+template <typename Reader>
+static void HashChunkBlocks(Reader& reader, ChunkHasher& hasher) {
+  while (true) {
+    auto block = reader.ReadBlock();
+
+    if (block.length == 0) {
+      break;
+    }
+
+    hasher.Update(block.data, block.length);
+  }
+}
+
+ChunkList HashFileChunks(const FileChunksRequest& request, uint32_t variant) {
+  const auto& context = request.file.context;
+
+  auto chunker = CreateChunker(request.chunking);
+  ChunkHasher hasher(variant, request.file.key, *chunker, context.offset);
+
+  if (request.file.preferMap) {
+    MemoryMappedFile file;
+
+    if (file.Open(context.path, context.offset, context.length,
+                  context.accessPattern)) {
+      file.Access(
+          [&](const uint8_t* address, size_t length) {
+            hasher.Update(address, length);
+          },
+          [] { throw PlatformException(MemoryMappedFile::ACCESS_ERROR); });
+
+      return hasher.Finish();
+    }
+  }
+
+  BlockReader reader;
+  ReadAheadBlockReader readAheadReader;
+  reader.Open(context.path, context.offset, context.length, context.blockSize,
+              context.accessPattern);
+
+  bool readAhead =
+      ShouldReadAhead(context.readAhead, reader.GetExpectedLength());
+
+  if (readAhead && readAheadReader.Start(reader)) {
+    HashChunkBlocks(readAheadReader, hasher);
+  } else {
+    HashChunkBlocks(reader, hasher);
+  }
+
+  return hasher.Finish();
+}
+
+DirectoryHashResult HashDirectory(const DirectoryHashRequest& request,
+                                  uint32_t variant) {
+  auto paths = ListDirectoryFiles(request.path, request.walkOptions);
+
+  std::vector<FileHashRequest> fileRequests;
+  fileRequests.reserve(paths.size());
+
+  for (const auto& path : paths) {
+    fileRequests.emplace_back(
+        HashWorkerContext(JoinPath(request.path, path), 0,
+                          std::numeric_limits<size_t>::max(),
+                          request.blockSize, ReadAheadMode::Auto,
+                          request.accessPattern),
+        request.key, request.preferMap);
+  }
+
+  auto hashes = HashFiles(fileRequests, variant, request.concurrency);
 
-  return result;
+  return {std::move(paths), std::move(hashes)};
 }
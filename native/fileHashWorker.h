@@ -1,57 +1,195 @@
 #pragma once
 
+#include <vector>
+
+#include "chunkHasher.h"
 #include "hashers.h"
+#include "platform/accessPattern.h"
 #include "platform/blockReader.h"
+#include "platform/directory.h"
 #include "platform/memoryMap.h"
 #include "platform/nativeString.h"
 #include "platform/platformError.h"
 
+enum class ReadAheadMode {
+  // Read ahead when at least READ_AHEAD_MIN_LENGTH bytes are expected.
+  Auto,
+  Never,
+  Always
+};
+
+constexpr size_t READ_AHEAD_MIN_LENGTH = BlockReader::LARGE_FILE_SIZE;
+
 struct HashWorkerContext {
   NativeString path;
   size_t offset;
   size_t length;
 
-  HashWorkerContext(NativeString path, size_t offset, size_t length)
-      : path(path), offset(offset), length(length) {}
+  // Used only when reading the file block by block, 0 - adaptive.
+  uint32_t blockSize;
+  ReadAheadMode readAhead;
+  AccessPattern accessPattern;
+
+  HashWorkerContext(NativeString path, size_t offset, size_t length,
+                    uint32_t blockSize = 0,
+                    ReadAheadMode readAhead = ReadAheadMode::Auto,
+                    AccessPattern accessPattern = AccessPattern::Sequential)
+      : path(path),
+        offset(offset),
+        length(length),
+        blockSize(blockSize),
+        readAhead(readAhead),
+        accessPattern(accessPattern) {}
+};
+
+struct FileHashRequest {
+  HashWorkerContext context;
+  HashKey key;
+  bool preferMap;
+
+  FileHashRequest(HashWorkerContext context, HashKey key, bool preferMap)
+      : context(context), key(key), preferMap(preferMap) {}
 };
 
 class HashWorker {
  public:
+  virtual ~HashWorker() {}
+
   virtual GenericHashResult Process(const HashWorkerContext& context) = 0;
 };
 
+// The worker can process several files in a row, reusing the state and the
+// buffers of the block reader.
 class BlockHashWorker : public HashWorker {
  public:
-  BlockHashWorker(uint32_t variant, uint64_t seed) : _state(variant, seed) {}
+  BlockHashWorker(uint32_t variant, HashKey key)
+      : _state(variant), _key(key) {}
 
   GenericHashResult Process(const HashWorkerContext& context) override;
 
+  void SetKey(const HashKey& key) { _key = key; }
+
  private:
   BlockReader _blockReader;
+  ReadAheadBlockReader _readAheadReader;
   XxHashDynamicState _state;
+  HashKey _key;
+
+  template <typename Reader>
+  void HashBlocks(Reader& reader);
 };
 
+// Ranges up to MemoryMappedFile::GetWindowSize() are hashed with a oneshot
+// method, larger ones - window by window.
 class MapHashWorker : public HashWorker {
  public:
-  MapHashWorker(uint32_t variant, uint64_t seed) : _variant(variant), _seed(seed) {}
+  MapHashWorker(uint32_t variant, HashKey key)
+      : _variant(variant), _state(variant), _key(key) {}
 
   GenericHashResult Process(const HashWorkerContext& context) override;
 
+  void SetKey(const HashKey& key) { _key = key; }
+
  private:
   uint32_t _variant;
-  uint64_t _seed;
+  XxHashDynamicState _state;
+  HashKey _key;
 };
 
 template <typename Worker>
 inline GenericHashResult _HashFile(const HashWorkerContext& context, uint32_t variant,
-                            uint64_t seed) {
-  Worker worker(variant, seed);
+                            const HashKey& key) {
+  Worker worker(variant, key);
 
   return worker.Process(context);
 }
 
 inline GenericHashResult HashFile(const HashWorkerContext& context, uint32_t variant,
-                           uint64_t seed, bool preferMap) {
-  return preferMap ? _HashFile<MapHashWorker>(context, variant, seed)
-                   : _HashFile<BlockHashWorker>(context, variant, seed);
+                           const HashKey& key, bool preferMap) {
+  return preferMap ? _HashFile<MapHashWorker>(context, variant, key)
+                   : _HashFile<BlockHashWorker>(context, variant, key);
+}
+
+inline GenericHashResult HashFile(const FileHashRequest& request,
+                                  uint32_t variant) {
+  return HashFile(request.context, variant, request.key, request.preferMap);
 }
+
+// Hashes all the files on concurrency threads (0 - number of hardware
+// threads). Each thread reuses its workers for all the files it processes.
+//
+// If useIoUring is set and io_uring is available, each thread reads several
+// files at once with it, otherwise the files are read one after another.
+//
+// Throws the first error that occurred.
+std::vector<GenericHashResult> HashFiles(
+    const std::vector<FileHashRequest>& requests, uint32_t variant,
+    uint32_t concurrency, bool useIoUring = true);
+
+constexpr size_t TREE_DEFAULT_CHUNK_SIZE = 16 * 1024 * 1024;
+
+struct FileTreeHashRequest {
+  FileHashRequest file;
+  size_t chunkSize;
+  uint32_t concurrency;
+
+  FileTreeHashRequest(FileHashRequest file, size_t chunkSize,
+                      uint32_t concurrency)
+      : file(file), chunkSize(chunkSize), concurrency(concurrency) {}
+};
+
+// Computes the chunked-tree digest of the file, which differs from the
+// digest of HashFile: the range is split into chunks of chunkSize bytes (the
+// last one may be shorter), chunks are hashed with the key on concurrency
+// threads (0 - number of hardware threads) and the result is the hash with
+// the same key of
+//
+//   canonical(chunk 0) || ... || canonical(chunk n - 1) ||
+//   be64(chunkSize) || be64(length)
+//
+// where canonical() is the big-endian form of a hash. Non-regular files are
+// read on the calling thread and yield the same digest.
+GenericHashResult HashFileTree(const FileTreeHashRequest& request,
+                               uint32_t variant);
+
+struct FileChunksRequest {
+  FileHashRequest file;
+  ChunkingOptions chunking;
+
+  FileChunksRequest(FileHashRequest file, ChunkingOptions chunking)
+      : file(file), chunking(chunking) {}
+};
+
+// Splits the range into chunks and hashes each of them with the key in a
+// single pass over the file. Offsets of the chunks are offsets in the file.
+ChunkList HashFileChunks(const FileChunksRequest& request, uint32_t variant);
+
+struct DirectoryHashRequest {
+  NativeString path;
+  DirectoryWalkOptions walkOptions;
+  HashKey key;
+  bool preferMap;
+  uint32_t blockSize;
+  AccessPattern accessPattern;
+  uint32_t concurrency;
+
+  DirectoryHashRequest(NativeString path, DirectoryWalkOptions walkOptions,
+                       HashKey key, bool preferMap, uint32_t blockSize,
+                       AccessPattern accessPattern, uint32_t concurrency)
+      : path(path),
+        walkOptions(walkOptions),
+        key(key),
+        preferMap(preferMap),
+        blockSize(blockSize),
+        accessPattern(accessPattern),
+        concurrency(concurrency) {}
+};
+
+struct DirectoryHashResult {
+  // Paths are relative to the directory.
+  std::vector<NativeString> paths;
+  std::vector<GenericHashResult> hashes;
+};
+
+DirectoryHashResult HashDirectory(const DirectoryHashRequest& request,
+                                  uint32_t variant);
@@ -1,9 +1,18 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <vector>
+
+// Layouts of the states are needed to save and load them.
+#ifndef XXH_STATIC_LINKING_ONLY
+#define XXH_STATIC_LINKING_ONLY
+#endif
 
 #include "xxhash.h"
+#include "xxhashDispatch.h"
 
 enum HashVariant { H32, H64, H3, H3_128 };
 
@@ -31,80 +40,247 @@ class GenericHashResult {
   XXH128_hash_t _value;
 };
 
-class XxHashDynamicState {
- public:
-  XxHashDynamicState() : _variant(0), _state(nullptr) {}
+// Size of a hash result in bytes when it's stored in memory.
+inline size_t GetHashResultSize(uint32_t variant) {
+  switch (variant) {
+    case H32:
+      return sizeof(uint32_t);
+    case H3_128:
+      return sizeof(XXH128_hash_t);
+    default:
+      return sizeof(uint64_t);
+  }
+}
 
-  XxHashDynamicState(uint32_t variant) : _variant(variant) {
-    switch (variant) {
-      case H32:
-        _state = XXH32_createState();
-        break;
-      case H64:
-        _state = XXH64_createState();
-        break;
-      case H3:
-      case H3_128:
-        _state = XXH3_createState();
-        break;
+// Stores the result in the native byte order: uint32_t for xxhash32,
+// uint64_t for xxhash64 and xxhash3, low and high uint64_t for xxhash3_128.
+// The destination doesn't have to be aligned.
+inline void StoreHashResult(uint32_t variant, GenericHashResult result,
+                            void* destination) {
+  switch (variant) {
+    case H32: {
+      auto value = (uint32_t)(uint64_t)result;
+
+      memcpy(destination, &value, sizeof(value));
+      break;
     }
+    case H3_128: {
+      XXH128_hash_t value = result;
+      uint64_t words[2] = {value.low64, value.high64};
 
-    if (_state == nullptr) {
-      throw std::runtime_error("Out of memory");
+      memcpy(destination, words, sizeof(words));
+      break;
+    }
+    default: {
+      auto value = (uint64_t)result;
+
+      memcpy(destination, &value, sizeof(value));
+      break;
     }
   }
+}
+
+// Stores the result in the canonical (big-endian) form, which is the same on
+// all platforms.
+inline void StoreCanonicalHashResult(uint32_t variant, GenericHashResult result,
+                                     void* destination) {
+  switch (variant) {
+    case H32:
+      XXH32_canonicalFromHash((XXH32_canonical_t*)destination,
+                              (XXH32_hash_t)(uint64_t)result);
+      break;
+    case H3_128:
+      XXH128_canonicalFromHash((XXH128_canonical_t*)destination, result);
+      break;
+    default:
+      XXH64_canonicalFromHash((XXH64_canonical_t*)destination,
+                              (uint64_t)result);
+      break;
+  }
+}
+
+// Whether the variant can be keyed with a custom secret.
+inline bool IsSecretSupported(uint32_t variant) {
+  return variant == H3 || variant == H3_128;
+}
+
+// Seed of a hash or, for xxhash3 and xxhash3_128, a custom secret that is used
+// instead of it. The secret is either borrowed (it should outlive the key and
+// everything reset with it) or owned by the key and its copies.
+struct HashKey {
+  uint64_t seed = 0;
+  const uint8_t* secret = nullptr;
+  size_t secretSize = 0;
+
+  HashKey(uint64_t seed = 0) : seed(seed) {}
+
+  static HashKey WithSecret(const uint8_t* secret, size_t secretSize) {
+    HashKey key;
+    key.secret = secret;
+    key.secretSize = secretSize;
 
-  XxHashDynamicState(uint32_t variant, uint64_t seed)
+    return key;
+  }
+
+  // Returns a key that owns a copy of the secret.
+  HashKey Own() const {
+    if (secret == nullptr) {
+      return *this;
+    }
+
+    HashKey key(seed);
+    key._ownedSecret =
+        std::make_shared<const std::vector<uint8_t>>(secret, secret + secretSize);
+    key.secret = key._ownedSecret->data();
+    key.secretSize = secretSize;
+
+    return key;
+  }
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> _ownedSecret;
+};
+
+// Oneshot hash with the variant known at compile time, for the bindings that
+// hash small inputs, possibly many in a loop.
+template <uint32_t Variant>
+inline GenericHashResult OneshotHashOf(const uint8_t* data, size_t length,
+                                       const HashKey& key) {
+  static_assert(Variant < HASH_VARIANTS_COUNT, "Unknown variant");
+
+  if constexpr (Variant == H32) {
+    return XXH32(data, length, (XXH32_hash_t)key.seed);
+  } else if constexpr (Variant == H64) {
+    return XXH64(data, length, key.seed);
+  } else if constexpr (Variant == H3) {
+    return key.secret != nullptr
+               ? XXH3_64bits_withSecret_dispatch(data, length, key.secret,
+                                                 key.secretSize)
+               : XXH3_64bits_withSeed_dispatch(data, length, key.seed);
+  } else {
+    return key.secret != nullptr
+               ? XXH3_128bits_withSecret_dispatch(data, length, key.secret,
+                                                  key.secretSize)
+               : XXH3_128bits_withSeed_dispatch(data, length, key.seed);
+  }
+}
+
+// The native state is stored inline, so creating and destroying states doesn't
+// allocate. It doesn't point into itself and can be copied as is.
+class XxHashDynamicState {
+ public:
+  XxHashDynamicState() : XxHashDynamicState(H32) {}
+
+  XxHashDynamicState(uint32_t variant) : _variant(variant) {
+    // Fields compared by XXH3 resets have to be initialized.
+    XXH3_INITSTATE(&_state.h3);
+  }
+
+  XxHashDynamicState(uint32_t variant, const HashKey& key)
       : XxHashDynamicState(variant) {
-    Reset(seed);
+    Reset(key);
   }
 
   XxHashDynamicState(const XxHashDynamicState& source) = delete;
 
-  XxHashDynamicState(XxHashDynamicState&& source) {
-    _variant = source._variant;
-    _state = source._state;
-    source._state = nullptr;
-  }
-
-  ~XxHashDynamicState() {
-    if (_state != nullptr) {
-      switch (_variant) {
-        case H32:
-          XXH32_freeState((XXH32_state_t*)_state);
-          break;
-        case H64:
-          XXH64_freeState((XXH64_state_t*)_state);
-          break;
-        case H3:
-        case H3_128:
-          XXH3_freeState((XXH3_state_t*)_state);
-          break;
-      }
+  XxHashDynamicState(XxHashDynamicState&& source) = default;
+  XxHashDynamicState& operator=(XxHashDynamicState&& other) = default;
+
+  // Returns an independent copy of the state. It refers to the same secret.
+  XxHashDynamicState Clone() const {
+    XxHashDynamicState clone(_variant);
+    memcpy(&clone._state, &_state, GetStateSize());
+
+    return clone;
+  }
+
+  // Size of the native state, see Save.
+  size_t GetStateSize() const {
+    switch (_variant) {
+      case H32:
+        return sizeof(XXH32_state_t);
+      case H64:
+        return sizeof(XXH64_state_t);
+      default:
+        return sizeof(XXH3_state_t);
     }
   }
 
-  XxHashDynamicState& operator=(XxHashDynamicState&& other) {
-    _variant = other._variant;
-    _state = other._state;
-    other._state = nullptr;
+  // Copies the native state as is, GetStateSize() bytes.
+  void Save(uint8_t* destination) const {
+    memcpy(destination, &_state, GetStateSize());
+  }
+
+  // Restores the state written by Save with the same version of xxhash. key
+  // has to be the one the state was created with: XXH3 states refer to the
+  // secret by a pointer, which is set by the reset. Returns false (and leaves
+  // the state reset) if the source is not a consistent state.
+  bool Load(const uint8_t* source, const HashKey& key) {
+    Reset(key);
+
+    switch (_variant) {
+      case H32: {
+        XXH32_state_t state;
+        memcpy(&state, source, sizeof(state));
+
+        if (state.bufferedSize >= sizeof(state.buffer)) {
+          return false;
+        }
+
+        _state.h32 = state;
+        break;
+      }
+      case H64: {
+        XXH64_state_t state;
+        memcpy(&state, source, sizeof(state));
+
+        if (state.bufferedSize >= sizeof(state.buffer)) {
+          return false;
+        }
+
+        _state.h64 = state;
+        break;
+      }
+      case H3:
+      case H3_128: {
+        auto state = &_state.h3;
+        XXH3_state_t reset = *state;
+
+        memcpy(state, source, sizeof(XXH3_state_t));
+        state->extSecret = reset.extSecret;
 
-    return *this;
+        bool isConsistent = state->bufferedSize <= sizeof(state->buffer) &&
+                            state->nbStripesPerBlock == reset.nbStripesPerBlock &&
+                            state->nbStripesSoFar < state->nbStripesPerBlock &&
+                            state->secretLimit == reset.secretLimit &&
+                            state->useSeed == reset.useSeed &&
+                            state->seed == reset.seed;
+
+        if (!isConsistent) {
+          Reset(key);
+          return false;
+        }
+        break;
+      }
+    }
+
+    return true;
   }
 
-  void Reset(uint64_t seed) {
+  // The state refers to the secret of the key until the next reset.
+  void Reset(const HashKey& key) {
     switch (_variant) {
       case H32:
-        XXH32_reset((XXH32_state_t*)_state, seed);
+        ResetOf<H32>(key);
         break;
       case H64:
-        XXH64_reset((XXH64_state_t*)_state, seed);
+        ResetOf<H64>(key);
         break;
       case H3:
-        XXH3_64bits_reset_withSeed((XXH3_state_t*)_state, seed);
+        ResetOf<H3>(key);
         break;
       case H3_128:
-        XXH3_128bits_reset_withSeed((XXH3_state_t*)_state, seed);
+        ResetOf<H3_128>(key);
         break;
     }
   }
@@ -112,16 +288,16 @@ class XxHashDynamicState {
   void Update(const uint8_t* data, size_t length) {
     switch (_variant) {
       case H32:
-        XXH32_update((XXH32_state_t*)_state, data, length);
+        UpdateOf<H32>(data, length);
         break;
       case H64:
-        XXH64_update((XXH64_state_t*)_state, data, length);
+        UpdateOf<H64>(data, length);
         break;
       case H3:
-        XXH3_64bits_update((XXH3_state_t*)_state, data, length);
+        UpdateOf<H3>(data, length);
         break;
       case H3_128:
-        XXH3_128bits_update((XXH3_state_t*)_state, data, length);
+        UpdateOf<H3_128>(data, length);
         break;
     }
   }
@@ -129,36 +305,97 @@ class XxHashDynamicState {
   GenericHashResult GetResult() const {
     switch (_variant) {
       case H32:
-        return XXH32_digest((XXH32_state_t*)_state);
+        return GetResultOf<H32>();
       case H64:
-        return XXH64_digest((XXH64_state_t*)_state);
+        return GetResultOf<H64>();
       case H3:
-        return XXH3_64bits_digest((XXH3_state_t*)_state);
+        return GetResultOf<H3>();
       case H3_128:
-        return XXH3_128bits_digest((XXH3_state_t*)_state);
+        return GetResultOf<H3_128>();
       default:
         return GenericHashResult();
     }
   }
 
+  // Reset, Update and GetResult with the variant known at compile time, for
+  // the bindings of the states of a single variant. Variant has to be the
+  // variant of the state.
+  template <uint32_t Variant>
+  void ResetOf(const HashKey& key) {
+    static_assert(Variant < HASH_VARIANTS_COUNT, "Unknown variant");
+
+    if constexpr (Variant == H32) {
+      XXH32_reset(&_state.h32, key.seed);
+    } else if constexpr (Variant == H64) {
+      XXH64_reset(&_state.h64, key.seed);
+    } else if constexpr (Variant == H3) {
+      if (key.secret != nullptr) {
+        XXH3_64bits_reset_withSecret(&_state.h3, key.secret, key.secretSize);
+      } else {
+        XXH3_64bits_reset_withSeed(&_state.h3, key.seed);
+      }
+    } else {
+      if (key.secret != nullptr) {
+        XXH3_128bits_reset_withSecret(&_state.h3, key.secret, key.secretSize);
+      } else {
+        XXH3_128bits_reset_withSeed(&_state.h3, key.seed);
+      }
+    }
+  }
+
+  template <uint32_t Variant>
+  void UpdateOf(const uint8_t* data, size_t length) {
+    static_assert(Variant < HASH_VARIANTS_COUNT, "Unknown variant");
+
+    if constexpr (Variant == H32) {
+      XXH32_update(&_state.h32, data, length);
+    } else if constexpr (Variant == H64) {
+      XXH64_update(&_state.h64, data, length);
+    } else if constexpr (Variant == H3) {
+      XXH3_64bits_update_dispatch(&_state.h3, data, length);
+    } else {
+      XXH3_128bits_update_dispatch(&_state.h3, data, length);
+    }
+  }
+
+  template <uint32_t Variant>
+  GenericHashResult GetResultOf() const {
+    static_assert(Variant < HASH_VARIANTS_COUNT, "Unknown variant");
+
+    if constexpr (Variant == H32) {
+      return XXH32_digest(&_state.h32);
+    } else if constexpr (Variant == H64) {
+      return XXH64_digest(&_state.h64);
+    } else if constexpr (Variant == H3) {
+      return XXH3_64bits_digest(&_state.h3);
+    } else {
+      return XXH3_128bits_digest(&_state.h3);
+    }
+  }
+
   static GenericHashResult Oneshot(uint32_t variant, const uint8_t* data,
-                                   size_t length, uint64_t seed) {
+                                   size_t length, const HashKey& key) {
     switch (variant) {
       case H32:
-        return XXH32(data, length, seed);
+        return OneshotHashOf<H32>(data, length, key);
       case H64:
-        return XXH64(data, length, seed);
-        break;
+        return OneshotHashOf<H64>(data, length, key);
       case H3:
-        return XXH3_64bits_withSeed(data, length, seed);
+        return OneshotHashOf<H3>(data, length, key);
       case H3_128:
-        return XXH3_128bits_withSeed(data, length, seed);
+        return OneshotHashOf<H3_128>(data, length, key);
       default:
         return GenericHashResult();
     }
   }
 
  private:
+  union State {
+    XXH32_state_t h32;
+    XXH64_state_t h64;
+    XXH3_state_t h3;
+  };
+
   uint32_t _variant;
-  void* _state = nullptr;
+  State _state;
 };
@@ -1,6 +1,7 @@
 #include "index.h"
 
 #include "jsHashState.h"
+#include "xxhashDispatch.h"
 
 #define FUNCTION_SET_ITEM(name, function, data) \
   InstanceMethod(name, &XxHashAddon::function, napi_default_method, data)
@@ -11,28 +12,65 @@
       FUNCTION_SET_ITEM("xxhash3_" #suffix, function, (void*)H3),  \
       FUNCTION_SET_ITEM("xxhash3_128_" #suffix, function, (void*)H3_128)
 
+#define TEMPLATE_FUNCTION_SET(suffix, function)                             \
+  InstanceMethod("xxhash32_" #suffix, &XxHashAddon::function<H32>,         \
+                 napi_default_method),                                     \
+      InstanceMethod("xxhash64_" #suffix, &XxHashAddon::function<H64>,     \
+                     napi_default_method),                                 \
+      InstanceMethod("xxhash3_" #suffix, &XxHashAddon::function<H3>,       \
+                     napi_default_method),                                 \
+      InstanceMethod("xxhash3_128_" #suffix, &XxHashAddon::function<H3_128>, \
+                     napi_default_method)
+
 XxHashAddon::XxHashAddon(Napi::Env env, Napi::Object exports) {
-  Napi::FunctionReference* stateCons = new Napi::FunctionReference(
-      Napi::Persistent(JsHashStateObject::Init(env)));
+  // Select XXH3 kernels while loading the addon rather than on the first hash.
+  XXH_activeVectorPath();
+
+  // Each variant has its own state class, see JsHashStateObject::Init.
+  auto stateCons = new Napi::FunctionReference[HASH_VARIANTS_COUNT];
+  stateCons[H32] =
+      Napi::Persistent(JsHashStateObject::Init<H32>(env, &stateCons[H32]));
+  stateCons[H64] =
+      Napi::Persistent(JsHashStateObject::Init<H64>(env, &stateCons[H64]));
+  stateCons[H3] =
+      Napi::Persistent(JsHashStateObject::Init<H3>(env, &stateCons[H3]));
+  stateCons[H3_128] = Napi::Persistent(
+      JsHashStateObject::Init<H3_128>(env, &stateCons[H3_128]));
 
   AddonData* data = new AddonData();
 
   for (uint32_t i = 0; i < HASH_VARIANTS_COUNT; i++) {
-    data->variants[i] = CreateStateData(i, stateCons);
+    data->variants[i] = CreateStateData(i, &stateCons[i]);
   }
 
   env.AddCleanupHook([stateCons, data]() {
-    stateCons->Reset();
+    for (uint32_t i = 0; i < HASH_VARIANTS_COUNT; i++) {
+      stateCons[i].Reset();
+    }
 
-    delete stateCons;
+    delete[] stateCons;
     delete data;
   });
 
   DefineAddon(exports,
               {
-                  FUNCTION_SET(oneshot, OneshotHash),
+                  TEMPLATE_FUNCTION_SET(oneshot, OneshotHash),
+                  TEMPLATE_FUNCTION_SET(oneshotString, OneshotStringHash),
+                  FUNCTION_SET(oneshotAsync, OneshotHashAsync),
+                  TEMPLATE_FUNCTION_SET(oneshotInto, OneshotHashInto),
+                  TEMPLATE_FUNCTION_SET(oneshotBatch, OneshotBatchHash),
+                  TEMPLATE_FUNCTION_SET(hashStrings, StringsHash),
+                  FUNCTION_SET(oneshotChunks, OneshotChunksHash),
                   FUNCTION_SET(file, FileHash),
+                  FUNCTION_SET(fileInto, FileHashInto),
                   FUNCTION_SET(fileAsync, FileHashAsync),
+                  FUNCTION_SET(fileTree, FileTreeHash),
+                  FUNCTION_SET(fileTreeAsync, FileTreeHashAsync),
+                  FUNCTION_SET(fileChunks, FileChunksHash),
+                  FUNCTION_SET(fileChunksAsync, FileChunksHashAsync),
+                  FUNCTION_SET(filesAsync, FilesHashAsync),
+                  FUNCTION_SET(directoryToMap, DirectoryHash),
+                  FUNCTION_SET(directoryToMapAsync, DirectoryHashAsync),
 
                   FUNCTION_SET_ITEM("xxhash32_createState", CreateHashState,
                                     &data->variants[H32]),
@@ -43,6 +81,27 @@ XxHashAddon::XxHashAddon(Napi::Env env, Napi::Object exports) {
                   FUNCTION_SET_ITEM("xxhash3_128_createState", CreateHashState,
                                     &data->variants[H3_128]),
 
+                  FUNCTION_SET_ITEM("xxhash32_createStateFromSerialized",
+                                    CreateHashStateFromSerialized,
+                                    &data->variants[H32]),
+                  FUNCTION_SET_ITEM("xxhash64_createStateFromSerialized",
+                                    CreateHashStateFromSerialized,
+                                    &data->variants[H64]),
+                  FUNCTION_SET_ITEM("xxhash3_createStateFromSerialized",
+                                    CreateHashStateFromSerialized,
+                                    &data->variants[H3]),
+                  FUNCTION_SET_ITEM("xxhash3_128_createStateFromSerialized",
+                                    CreateHashStateFromSerialized,
+                                    &data->variants[H3_128]),
+
+                  InstanceMethod("generateSecret", &XxHashAddon::GenerateSecret,
+                                 napi_default_method),
+                  InstanceMethod("getCpuFeatures", &XxHashAddon::GetCpuFeatures,
+                                 napi_default_method),
+                  InstanceMethod("activeVectorPath",
+                                 &XxHashAddon::GetActiveVectorPath,
+                                 napi_default_method),
+
               });
 }
 
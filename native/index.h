@@ -21,13 +21,47 @@ class XxHashAddon : public Napi::Addon<XxHashAddon> {
   public:
     XxHashAddon(Napi::Env env, Napi::Object exports);
 
+    // The variant is a template parameter rather than the data of the
+    // function: these are called for small inputs, often in a loop.
+    template <uint32_t Variant>
     Napi::Value OneshotHash(const Napi::CallbackInfo& info);
+    template <uint32_t Variant>
+    Napi::Value OneshotStringHash(const Napi::CallbackInfo& info);
+    template <uint32_t Variant>
+    Napi::Value OneshotHashInto(const Napi::CallbackInfo& info);
+    template <uint32_t Variant>
+    Napi::Value OneshotBatchHash(const Napi::CallbackInfo& info);
+    template <uint32_t Variant>
+    Napi::Value StringsHash(const Napi::CallbackInfo& info);
+
+    Napi::Value OneshotHashAsync(const Napi::CallbackInfo& info);
+    Napi::Value OneshotChunksHash(const Napi::CallbackInfo& info);
     Napi::Value CreateHashState(const Napi::CallbackInfo& info);
+    Napi::Value CreateHashStateFromSerialized(const Napi::CallbackInfo& info);
     Napi::Value FileHash(const Napi::CallbackInfo& info);
+    Napi::Value FileHashInto(const Napi::CallbackInfo& info);
     Napi::Value FileHashAsync(const Napi::CallbackInfo& info);
+    Napi::Value FileTreeHash(const Napi::CallbackInfo& info);
+    Napi::Value FileTreeHashAsync(const Napi::CallbackInfo& info);
+    Napi::Value FileChunksHash(const Napi::CallbackInfo& info);
+    Napi::Value FileChunksHashAsync(const Napi::CallbackInfo& info);
+    Napi::Value FilesHashAsync(const Napi::CallbackInfo& info);
+    Napi::Value DirectoryHash(const Napi::CallbackInfo& info);
+    Napi::Value DirectoryHashAsync(const Napi::CallbackInfo& info);
+
+    Napi::Value GenerateSecret(const Napi::CallbackInfo& info);
+    Napi::Value GetCpuFeatures(const Napi::CallbackInfo& info);
+    Napi::Value GetActiveVectorPath(const Napi::CallbackInfo& info);
 
   private:
     static uint32_t GetVariantData(const Napi::CallbackInfo& info) {
       return (uint32_t)reinterpret_cast<size_t>(info.Data());
     }
-};
\ No newline at end of file
+};
+
+// Instantiates a template method of XxHashAddon for all the variants.
+#define INSTANTIATE_VARIANT_METHOD(function)                                 \
+  template Napi::Value XxHashAddon::function<H32>(const Napi::CallbackInfo&); \
+  template Napi::Value XxHashAddon::function<H64>(const Napi::CallbackInfo&); \
+  template Napi::Value XxHashAddon::function<H3>(const Napi::CallbackInfo&);  \
+  template Napi::Value XxHashAddon::function<H3_128>(const Napi::CallbackInfo&)
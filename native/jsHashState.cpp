@@ -2,42 +2,118 @@
 
 #include <napi.h>
 
+#include <cstdio>
+
 #include "index.h"
 #include "jsObjectParser.h"
 #include "jsUtils.h"
+#include "stateSerialization.h"
 
-Napi::Function JsHashStateObject::Init(Napi::Env env) {
+template <uint32_t Variant>
+Napi::Function JsHashStateObject::Init(Napi::Env env,
+                                       Napi::FunctionReference* constructor) {
   return DefineClass(
       env, "XxHashState",
-      {InstanceMethod("reset", &JsHashStateObject::Reset, napi_default_method),
-       InstanceMethod("update", &JsHashStateObject::Update,
+      {InstanceMethod("reset", &JsHashStateObject::Reset<Variant>,
+                      napi_default_method),
+       InstanceMethod("update", &JsHashStateObject::Update<Variant>,
+                      napi_default_method),
+       InstanceMethod("updateAsync", &JsHashStateObject::UpdateAsync,
+                      napi_default_method),
+       InstanceMethod("result", &JsHashStateObject::GetResult<Variant>,
+                      napi_default_method),
+       InstanceMethod("resultInto", &JsHashStateObject::GetResultInto<Variant>,
+                      napi_default_method),
+       InstanceMethod("clone", &JsHashStateObject::Clone, napi_default_method,
+                      constructor),
+       InstanceMethod("serialize", &JsHashStateObject::Serialize,
                       napi_default_method),
-       InstanceMethod("result", &JsHashStateObject::GetResult,
-                      napi_default_method)});
+       InstanceMethod("dispose", &JsHashStateObject::Dispose,
+                      napi_default_method)},
+      (void*)(size_t)Variant);
 }
 
 JsHashStateObject::JsHashStateObject(const Napi::CallbackInfo& info)
     : Napi::ObjectWrap<JsHashStateObject>(info) {
   auto env = info.Env();
 
-  if (info.Length() != 2) {
+  // (seed), the variant is the data of the class, so that the methods
+  // specialized for it can't be called on a state of another variant.
+  if (info.Length() != 1) {
     throw Napi::Error::New(env, "Wrong number of arguments");
   }
 
-  uint32_t variant = JsParseArgument<uint32_t>(env, info[0], "variant");
-  uint64_t seed = JsParseSeedArgument(env, variant, info[1]);
-
-  _seed = seed;
+  uint32_t variant = (uint32_t)reinterpret_cast<size_t>(info.Data());
+  _key = JsParseHashKeyArgument(env, variant, info[0]).Own();
   _variant = variant;
-  _state = XxHashDynamicState(variant, seed);
+  _state = XxHashDynamicState(variant, _key);
 }
 
+// Hashes a buffer into the state on a worker thread. The input (see
+// JsAsyncInput) and the state object are kept alive until the update
+// completes.
+class JsHashStateObject::UpdateWorker : public Napi::AsyncWorker {
+ public:
+  UpdateWorker(JsHashStateObject* owner, Napi::Object buffer, RawSizedArray data)
+      : Napi::AsyncWorker(buffer.Env()),
+        _owner(owner),
+        _input(buffer, data),
+        _deferred(Napi::Promise::Deferred::New(buffer.Env())) {
+    _owner->Ref();
+  }
+
+  Napi::Promise Promise() const { return _deferred.Promise(); }
+
+  void Execute() override {
+    _owner->_state.Update(_input.Data(), _input.Length());
+  }
+
+  void OnOK() override {
+    auto env = Env();
+
+    // Start the next update before the promise is resolved, so that the state
+    // is idle in the continuation if nothing else is queued.
+    auto& pendingUpdates = _owner->_pendingUpdates;
+    pendingUpdates.pop_front();
+
+    if (!pendingUpdates.empty()) {
+      pendingUpdates.front()->Queue();
+    }
+
+    _owner->Unref();
+    _deferred.Resolve(env.Undefined());
+  }
+
+ private:
+  JsHashStateObject* _owner;
+  JsAsyncInput _input;
+  Napi::Promise::Deferred _deferred;
+};
+
+void JsHashStateObject::CheckNotDisposed(Napi::Env env) const {
+  if (_disposed) {
+    throw Napi::Error::New(env, "The state is disposed");
+  }
+}
+
+void JsHashStateObject::CheckUsable(Napi::Env env) const {
+  CheckNotDisposed(env);
+
+  if (!_pendingUpdates.empty()) {
+    throw Napi::Error::New(
+        env, "The state can't be used until updateAsync() calls complete");
+  }
+}
+
+template <uint32_t Variant>
 Napi::Value JsHashStateObject::Reset(const Napi::CallbackInfo& info) {
-  _state.Reset(_seed);
+  CheckUsable(info.Env());
+  _state.ResetOf<Variant>(_key);
 
   return info.Env().Undefined();
 }
 
+template <uint32_t Variant>
 Napi::Value JsHashStateObject::Update(const Napi::CallbackInfo& info) {
   auto env = info.Env();
 
@@ -47,14 +123,143 @@ Napi::Value JsHashStateObject::Update(const Napi::CallbackInfo& info) {
 
   auto data = JsParseArgument<RawSizedArray>(env, info[0], "data");
 
-  _state.Update(data.data, data.length);
+  CheckUsable(env);
+  _state.UpdateOf<Variant>(data.data, data.length);
 
   return env.Undefined();
 }
 
+Napi::Value JsHashStateObject::UpdateAsync(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  auto data = JsParseArgument<RawSizedArray>(env, info[0], "data");
+  CheckNotDisposed(env);
+
+  auto worker = new UpdateWorker(this, info[0].As<Napi::Object>(), data);
+
+  _pendingUpdates.push_back(worker);
+
+  if (_pendingUpdates.size() == 1) {
+    worker->Queue();
+  }
+
+  return worker->Promise();
+}
+
+template <uint32_t Variant>
 Napi::Value JsHashStateObject::GetResult(const Napi::CallbackInfo& info) {
   auto env = info.Env();
-  XXH128_hash_t result = _state.GetResult();
+  CheckUsable(env);
+  auto result = _state.GetResultOf<Variant>();
 
-  return JsParseHashResult(env, _variant, result);
+  return JsParseHashResult(env, Variant, result);
 }
+
+template <uint32_t Variant>
+Napi::Value JsHashStateObject::GetResultInto(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  // (out, offset?)
+  if (info.Length() < 1 || info.Length() > 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  uint8_t* destination =
+      JsParseHashResultDestination(env, Variant, info[0], info[1]);
+
+  CheckUsable(env);
+  StoreHashResult(Variant, _state.GetResultOf<Variant>(), destination);
+
+  return env.Undefined();
+}
+
+Napi::Value JsHashStateObject::Clone(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  CheckUsable(env);
+  auto constructor = (Napi::FunctionReference*)info.Data();
+
+  auto object = constructor->New({env.Undefined()});
+  auto clone = Unwrap(object);
+
+  // The key shares the owned secret, which the copied XXH3 state refers to.
+  clone->_key = _key;
+  clone->_state = _state.Clone();
+
+  return object;
+}
+
+Napi::Value JsHashStateObject::Serialize(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  CheckUsable(env);
+  auto result =
+      Napi::Uint8Array::New(env, GetSerializedStateSize(_state, _key));
+
+  SerializeState(_variant, _state, _key, result.Data());
+
+  return result;
+}
+
+Napi::Value JsHashStateObject::Dispose(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  // Disposing twice is fine.
+  if (!_disposed) {
+    CheckUsable(env);
+
+    _disposed = true;
+    _key = HashKey();
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value JsHashStateObject::FromSerialized(
+    Napi::Env env, Napi::FunctionReference* constructor, uint32_t variant,
+    Napi::Value data) {
+  static const char* VARIANT_NAMES[] = {"xxhash32", "xxhash64", "xxhash3",
+                                        "xxhash3_128"};
+
+  auto serialized = JsParseArgument<RawSizedArray>(env, data, "data");
+
+  XxHashDynamicState state;
+  HashKey key;
+  auto status = DeserializeState(variant, serialized.data, serialized.length,
+                                 state, key);
+
+  if (status != StateDeserializationStatus::Ok) {
+    JsValueParseContext context(env, "data", "parameter");
+
+    if (status == StateDeserializationStatus::IncompatibleVersion) {
+      context.InvalidValue("serialized by a compatible version of the library");
+    } else if (status == StateDeserializationStatus::VariantMismatch) {
+      char expectedValue[64];
+      snprintf(expectedValue, sizeof(expectedValue), "a serialized %s state",
+               VARIANT_NAMES[variant]);
+
+      context.InvalidValue(expectedValue);
+    } else {
+      context.InvalidValue("a serialized hash state");
+    }
+  }
+
+  auto object = constructor->New({env.Undefined()});
+  auto result = Unwrap(object);
+
+  result->_key = key;
+  result->_state = std::move(state);
+
+  return object;
+}
+
+template Napi::Function JsHashStateObject::Init<H32>(Napi::Env,
+                                                     Napi::FunctionReference*);
+template Napi::Function JsHashStateObject::Init<H64>(Napi::Env,
+                                                     Napi::FunctionReference*);
+template Napi::Function JsHashStateObject::Init<H3>(Napi::Env,
+                                                    Napi::FunctionReference*);
+template Napi::Function JsHashStateObject::Init<H3_128>(
+    Napi::Env, Napi::FunctionReference*);
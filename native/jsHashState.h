@@ -3,6 +3,7 @@
 #include <napi.h>
 
 #include <cstdint>
+#include <deque>
 
 #include "hashers.h"
 
@@ -10,14 +11,50 @@ class JsHashStateObject : public Napi::ObjectWrap<JsHashStateObject> {
  public:
   JsHashStateObject(const Napi::CallbackInfo& info);
 
+  // The variant is a template parameter of the methods used for small
+  // inputs, each variant has its own class.
+  template <uint32_t Variant>
   Napi::Value Reset(const Napi::CallbackInfo& info);
+  template <uint32_t Variant>
   Napi::Value Update(const Napi::CallbackInfo& info);
+  template <uint32_t Variant>
   Napi::Value GetResult(const Napi::CallbackInfo& info);
+  template <uint32_t Variant>
+  Napi::Value GetResultInto(const Napi::CallbackInfo& info);
 
-  static Napi::Function Init(Napi::Env env);
+  Napi::Value UpdateAsync(const Napi::CallbackInfo& info);
+  Napi::Value Clone(const Napi::CallbackInfo& info);
+  Napi::Value Serialize(const Napi::CallbackInfo& info);
+  Napi::Value Dispose(const Napi::CallbackInfo& info);
+
+  // Creates a state from the result of serialize(), constructor is the class
+  // of the variant.
+  static Napi::Value FromSerialized(Napi::Env env,
+                                    Napi::FunctionReference* constructor,
+                                    uint32_t variant, Napi::Value data);
+
+  // Defines the class of the states of the variant, which are constructed
+  // with (seed). clone() creates states with constructor, which the caller
+  // sets to the returned class.
+  template <uint32_t Variant>
+  static Napi::Function Init(Napi::Env env,
+                             Napi::FunctionReference* constructor);
 
  private:
+  class UpdateWorker;
+
+  void CheckNotDisposed(Napi::Env env) const;
+
+  // Throws if the state is disposed or asynchronous updates are queued: they
+  // use the state on a worker thread.
+  void CheckUsable(Napi::Env env) const;
+
+  // Updates run one at a time in the order they were queued; the first one
+  // is running.
+  std::deque<UpdateWorker*> _pendingUpdates;
+
   XxHashDynamicState _state;
   uint32_t _variant;
-  uint64_t _seed;
+  HashKey _key;
+  bool _disposed = false;
 };
@@ -2,6 +2,9 @@
 
 #include <cmath>
 
+#include "chunkHasher.h"
+#include "platform/accessPattern.h"
+
 #define CONVERT_DECL(type)                                               \
   template <>                                                            \
   type JsValueConverter<type>::Convert(Napi::Env env, Napi::Value value, \
@@ -23,6 +26,7 @@
 SINGLE_CHECK_CONVERTER(Napi::String, IsString, "string")
 SINGLE_CHECK_CONVERTER(Napi::Object, IsObject, "object")
 SINGLE_CHECK_CONVERTER(Napi::Function, IsFunction, "function")
+SINGLE_CHECK_CONVERTER(Napi::Array, IsArray, "array")
 
 template <typename UInt, typename Int = std::make_signed_t<UInt>>
 UInt ToPositiveIntChecked(Napi::Value value, const JsValueParseContext& context,
@@ -83,6 +87,54 @@ CONVERT_DECL(bool) {
 
 CONVERT_BACK_DECL(bool) { return Napi::Boolean::New(env, value); }
 
+CONVERT_DECL(Napi::Uint32Array) {
+  if (value.IsTypedArray() &&
+      value.As<Napi::TypedArray>().TypedArrayType() == napi_uint32_array) {
+    return value.As<Napi::Uint32Array>();
+  }
+
+  context.InvalidType("Uint32Array");
+}
+
+CONVERT_BACK_DECL(Napi::Uint32Array) { return value; }
+
+CONVERT_DECL(AccessPattern) {
+  if (value.IsString()) {
+    std::string name = value.As<Napi::String>().Utf8Value();
+
+    if (name == "normal") {
+      return AccessPattern::Normal;
+    } else if (name == "sequential") {
+      return AccessPattern::Sequential;
+    } else if (name == "populate") {
+      return AccessPattern::Populate;
+    } else if (name == "noreuse") {
+      return AccessPattern::NoReuse;
+    }
+
+    context.InvalidValue(
+        "one of 'normal', 'sequential', 'populate', 'noreuse'");
+  }
+
+  context.InvalidType("string");
+}
+
+CONVERT_DECL(ChunkingMode) {
+  if (value.IsString()) {
+    std::string name = value.As<Napi::String>().Utf8Value();
+
+    if (name == "fixed") {
+      return ChunkingMode::Fixed;
+    } else if (name == "cdc") {
+      return ChunkingMode::ContentDefined;
+    }
+
+    context.InvalidValue("one of 'fixed', 'cdc'");
+  }
+
+  context.InvalidType("string");
+}
+
 CONVERT_DECL(XXH128_hash_t) {
   if (value.IsBigInt()) {
     auto bigint = value.UnsafeAs<Napi::BigInt>();
@@ -117,15 +169,16 @@ CONVERT_BACK_DECL(XXH128_hash_t) {
 }
 
 CONVERT_DECL(RawSizedArray) {
-  if (value.IsTypedArray()) {
-    auto array = value.UnsafeAs<Napi::TypedArray>();
-
-    if (array.ElementSize() == 1) {
-      uint8_t* data = (uint8_t*)array.ArrayBuffer().Data();
-      size_t offset = array.ByteOffset();
-      size_t length = array.ByteLength();
-
-      return {data + offset, length};
+  JsTypedArrayInfo info;
+
+  if (JsGetTypedArrayInfo(env, value, info)) {
+    switch (info.type) {
+      case napi_int8_array:
+      case napi_uint8_array:
+      case napi_uint8_clamped_array:
+        return {info.data, info.length};
+      default:
+        break;
     }
   }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <vector>
 
 #include "napi.h"
 #include "xxhash.h"
@@ -13,6 +14,67 @@ struct RawSizedArray {
   RawSizedArray(uint8_t* data, size_t length) : data(data), length(length) {}
 };
 
+struct JsTypedArrayInfo {
+  napi_typedarray_type type;
+  uint8_t* data;
+  size_t length;
+};
+
+// Gets the type, data (already adjusted by the byte offset) and element count
+// of a typed array in a single N-API call, which is noticeably cheaper than
+// going through Napi::TypedArray and its ArrayBuffer on hot paths. Returns
+// false if value isn't a typed array.
+inline bool JsGetTypedArrayInfo(Napi::Env env, Napi::Value value,
+                                JsTypedArrayInfo& info) {
+  void* data;
+  napi_status status = napi_get_typedarray_info(
+      env, value, &info.type, &info.length, &data, nullptr, nullptr);
+
+  info.data = (uint8_t*)data;
+
+  return status == napi_ok;
+}
+
+// Encodes JS strings to UTF-8 (lone surrogates are replaced with U+FFFD, like
+// Buffer.from does). Short strings are encoded into the inline buffer with a
+// single N-API call. Longer ones are measured first and encoded into a heap
+// buffer, which is reused by the next calls.
+class JsUtf8Encoder {
+ public:
+  // Returns false if value isn't a string. The result is valid until the next
+  // call.
+  bool Encode(Napi::Env env, Napi::Value value, RawSizedArray& result) {
+    size_t length;
+    napi_status status = napi_get_value_string_utf8(env, value, _inline,
+                                                    INLINE_SIZE, &length);
+
+    if (status != napi_ok) {
+      return false;
+    }
+
+    // Only whole characters (up to 4 bytes) are written, and one byte is
+    // taken by the terminating zero: the string might be truncated unless
+    // there's room for another character.
+    if (length + 4 < INLINE_SIZE - 1) {
+      result = {(uint8_t*)_inline, length};
+      return true;
+    }
+
+    napi_get_value_string_utf8(env, value, nullptr, 0, &length);
+    _heap.resize(length + 1);
+    napi_get_value_string_utf8(env, value, _heap.data(), _heap.size(), &length);
+
+    result = {(uint8_t*)_heap.data(), length};
+    return true;
+  }
+
+ private:
+  static constexpr size_t INLINE_SIZE = 1024;
+
+  char _inline[INLINE_SIZE];
+  std::vector<char> _heap;
+};
+
 class JsValueParseContext {
  private:
   Napi::Env _env;
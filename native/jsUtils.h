@@ -2,7 +2,12 @@
 
 #include <napi.h>
 
+#include <vector>
+
+#include "chunkHasher.h"
 #include "hashers.h"
+#include "jsObjectParser.h"
+#include "platform/blockReader.h"
 
 template <typename CharType>
 std::basic_string<CharType> JsStringToCString(Napi::String text);
@@ -17,6 +22,15 @@ inline std::u16string JsStringToCString<char16_t>(Napi::String text) {
   return text.Utf16Value();
 }
 
+inline Napi::String CStringToJsString(Napi::Env env, const std::string& text) {
+  return Napi::String::New(env, text);
+}
+
+inline Napi::String CStringToJsString(Napi::Env env,
+                                      const std::u16string& text) {
+  return Napi::String::New(env, text);
+}
+
 inline uint64_t JsParseSeedArgument(Napi::Env env, uint32_t variant,
                                     Napi::Value value) {
   return variant == H32 ? JsParseArgument<uint32_t>(env, value, "seed", 0)
@@ -29,6 +43,81 @@ inline uint64_t JsParseSeedProperty(Napi::Env env, uint32_t variant,
                         : JsParseProperty<uint64_t>(env, value, "seed", 0);
 }
 
+// Parses the blockSize property, 0 (adaptive) if it's not specified.
+inline uint32_t JsParseBlockSizeProperty(Napi::Env env, Napi::Object options) {
+  auto blockSize = JsParseProperty<uint32_t>(env, options, "blockSize", 0);
+
+  if (blockSize > BlockReader::MAX_BLOCK_SIZE) {
+    JsValueParseContext(env, "blockSize", "property")
+        .InvalidValue("at most 64 MiB");
+  }
+
+  return blockSize;
+}
+
+// Returns true if value is a Uint8Array, and then checks that it's at least
+// XXH3_SECRET_SIZE_MIN bytes long.
+inline bool JsParseSecret(Napi::Env env, Napi::Value value,
+                          const JsValueParseContext& context,
+                          RawSizedArray& secret) {
+  JsTypedArrayInfo info;
+
+  if (!JsGetTypedArrayInfo(env, value, info) ||
+      info.type != napi_uint8_array) {
+    return false;
+  }
+
+  if (info.length < XXH3_SECRET_SIZE_MIN) {
+    context.InvalidValue("at least 136 bytes long");
+  }
+
+  secret = {info.data, info.length};
+
+  return true;
+}
+
+// Parses a seed or, for xxhash3 variants, a secret. The key borrows the secret.
+inline HashKey JsParseHashKeyArgument(Napi::Env env, uint32_t variant,
+                                      Napi::Value value) {
+  RawSizedArray secret;
+
+  if (IsSecretSupported(variant) &&
+      JsParseSecret(env, value, {env, "seed", "parameter"}, secret)) {
+    return HashKey::WithSecret(secret.data, secret.length);
+  }
+
+  return JsParseSeedArgument(env, variant, value);
+}
+
+// Parses seed and secret properties, only one of them can be specified. The
+// key borrows the secret.
+inline HashKey JsParseHashKeyProperty(Napi::Env env, uint32_t variant,
+                                      Napi::Object options) {
+  auto secretValue = options.Get("secret");
+
+  if (secretValue.IsUndefined()) {
+    return JsParseSeedProperty(env, variant, options);
+  }
+
+  JsValueParseContext context(env, "secret", "property", true);
+  RawSizedArray secret;
+
+  if (!IsSecretSupported(variant)) {
+    context.InvalidValue("undefined for xxhash32 and xxhash64");
+  }
+
+  if (!JsParseSecret(env, secretValue, context, secret)) {
+    context.InvalidType("Uint8Array");
+  }
+
+  if (!options.Get("seed").IsUndefined()) {
+    JsValueParseContext(env, "seed", "property")
+        .InvalidValue("undefined when secret is specified");
+  }
+
+  return HashKey::WithSecret(secret.data, secret.length);
+}
+
 inline Napi::Value JsParseHashResult(Napi::Env env, uint32_t variant,
                                      GenericHashResult result) {
   switch (variant) {
@@ -42,4 +131,186 @@ inline Napi::Value JsParseHashResult(Napi::Env env, uint32_t variant,
     default:
       return env.Undefined();
   }
-}
\ No newline at end of file
+}
+
+// Returns the data of the typed array that receives count hash results:
+// Uint32Array for xxhash32, BigUint64Array for the others (two elements per
+// result for xxhash3_128).
+inline uint8_t* JsParseHashResultArray(Napi::Env env, uint32_t variant,
+                                       Napi::Value value, size_t count,
+                                       const char* name) {
+  JsValueParseContext context(env, name, "parameter",
+                              /*allowUndefined = */ true);
+
+  auto expectedType = variant == H32 ? napi_uint32_array : napi_biguint64_array;
+
+  if (!value.IsTypedArray() ||
+      value.As<Napi::TypedArray>().TypedArrayType() != expectedType) {
+    context.InvalidType(variant == H32 ? "Uint32Array" : "BigUint64Array");
+  }
+
+  auto array = value.As<Napi::TypedArray>();
+
+  if (array.ByteLength() < count * GetHashResultSize(variant)) {
+    context.InvalidValue("large enough to hold all the results");
+  }
+
+  return (uint8_t*)array.ArrayBuffer().Data() + array.ByteOffset();
+}
+
+// Returns the address at which a single hash result is stored in out: a
+// Uint8Array or the array type accepted by JsParseHashResultArray. The offset
+// is measured in elements of out.
+inline uint8_t* JsParseHashResultDestination(Napi::Env env, uint32_t variant,
+                                             Napi::Value out,
+                                             Napi::Value offsetValue) {
+  auto resultType = variant == H32 ? napi_uint32_array : napi_biguint64_array;
+  JsTypedArrayInfo array;
+
+  if (!JsGetTypedArrayInfo(env, out, array) ||
+      (array.type != napi_uint8_array && array.type != resultType)) {
+    JsValueParseContext(env, "out", "parameter")
+        .InvalidType(variant == H32 ? "Uint8Array or Uint32Array"
+                                    : "Uint8Array or BigUint64Array");
+  }
+
+  uint32_t offset = JsParseArgument<uint32_t>(env, offsetValue, "offset", 0);
+
+  size_t elementSize = array.type == napi_uint8_array ? 1
+                       : variant == H32               ? sizeof(uint32_t)
+                                                      : sizeof(uint64_t);
+  size_t byteLength = array.length * elementSize;
+  size_t byteOffset = (size_t)offset * elementSize;
+
+  if (offset > array.length ||
+      byteLength - byteOffset < GetHashResultSize(variant)) {
+    JsValueParseContext(env, "offset", "parameter")
+        .InvalidValue("leave enough room for the result in out");
+  }
+
+  return array.data + byteOffset;
+}
+
+// Creates a typed array for count hash results, see JsParseHashResultArray.
+inline Napi::TypedArray JsCreateHashResultArray(Napi::Env env,
+                                                uint32_t variant,
+                                                size_t count) {
+  switch (variant) {
+    case H32:
+      return Napi::Uint32Array::New(env, count);
+    case H3_128:
+      return Napi::BigUint64Array::New(env, count * 2);
+    default:
+      return Napi::BigUint64Array::New(env, count);
+  }
+}
+
+// Parses chunking, chunkSize, minChunkSize and maxChunkSize properties. In
+// the 'cdc' mode chunkSize is the average size of a chunk, the minimum and
+// maximum sizes default to a quarter and 8 times of it.
+inline ChunkingOptions JsParseChunkingOptions(Napi::Env env,
+                                              Napi::Object options) {
+  auto mode = JsParseProperty<ChunkingMode>(env, options, "chunking",
+                                            ChunkingMode::Fixed);
+  size_t chunkSize = JsParseProperty<uint32_t>(env, options, "chunkSize");
+
+  if (mode == ChunkingMode::Fixed) {
+    if (chunkSize == 0) {
+      JsValueParseContext(env, "chunkSize", "property")
+          .InvalidValue("a positive integer");
+    }
+
+    return {mode, chunkSize, chunkSize, chunkSize};
+  }
+
+  if (chunkSize < GearChunker::MIN_AVG_CHUNK_SIZE) {
+    JsValueParseContext(env, "chunkSize", "property")
+        .InvalidValue("at least 64 in the 'cdc' mode");
+  }
+
+  size_t minChunkSize = JsParseProperty<uint32_t>(env, options, "minChunkSize",
+                                                  (uint32_t)(chunkSize / 4));
+  size_t maxChunkSize = JsParseProperty<uint64_t>(env, options, "maxChunkSize",
+                                                  (uint64_t)chunkSize * 8);
+
+  if (minChunkSize > chunkSize) {
+    JsValueParseContext(env, "minChunkSize", "property")
+        .InvalidValue("at most chunkSize");
+  }
+
+  if (maxChunkSize < chunkSize) {
+    JsValueParseContext(env, "maxChunkSize", "property")
+        .InvalidValue("at least chunkSize");
+  }
+
+  return {mode, chunkSize, minChunkSize, maxChunkSize};
+}
+
+// Converts the chunks to { offsets, lengths, hashes }: offsets and lengths are
+// Float64Array, hashes - the array created by JsCreateHashResultArray.
+inline Napi::Object JsCreateChunkList(Napi::Env env, uint32_t variant,
+                                      const ChunkList& chunks) {
+  size_t count = chunks.offsets.size();
+
+  auto offsets = Napi::Float64Array::New(env, count);
+  auto lengths = Napi::Float64Array::New(env, count);
+  auto hashes = JsCreateHashResultArray(env, variant, count);
+
+  uint8_t* hashData = JsParseHashResultArray(env, variant, hashes, count, "hashes");
+  size_t resultSize = GetHashResultSize(variant);
+
+  for (size_t i = 0; i < count; i++) {
+    offsets[i] = (double)chunks.offsets[i];
+    lengths[i] = (double)chunks.lengths[i];
+
+    StoreHashResult(variant, chunks.hashes[i], hashData + i * resultSize);
+  }
+
+  auto result = Napi::Object::New(env);
+  result.Set("offsets", offsets);
+  result.Set("lengths", lengths);
+  result.Set("hashes", hashes);
+
+  return result;
+}
+
+// Data of a typed array hashed on a worker thread. A reference keeps the
+// buffer from being garbage collected, but not from being detached (e.g.
+// transferred to another thread), which frees its memory. Inputs up to
+// COPY_MAX_LENGTH bytes are copied, so only larger ones rely on the caller
+// keeping the buffer attached until the work completes.
+class JsAsyncInput {
+ public:
+  static constexpr size_t COPY_MAX_LENGTH = 64 * 1024;
+
+  JsAsyncInput(Napi::Object buffer, RawSizedArray data) : _data(data) {
+    if (data.length <= COPY_MAX_LENGTH) {
+      _copy.assign(data.data, data.data + data.length);
+      _data.data = _copy.data();
+    } else {
+      _buffer = Napi::Persistent(buffer);
+    }
+  }
+
+  JsAsyncInput(const JsAsyncInput& other) = delete;
+
+  const uint8_t* Data() const { return _data.data; }
+  size_t Length() const { return _data.length; }
+
+ private:
+  Napi::ObjectReference _buffer;
+  std::vector<uint8_t> _copy;
+  RawSizedArray _data;
+};
+
+inline void ExecuteCallbackWithErrorOrThrow(Napi::Env env,
+                                            const Napi::Function& callback,
+                                            const Napi::String& message) {
+  auto error = Napi::Error::New(env, message);
+
+  if (callback.IsUndefined()) {
+    error.ThrowAsJavaScriptException();
+  } else {
+    callback.Call({error.Value()});
+  }
+}
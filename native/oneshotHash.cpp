@@ -1,18 +1,21 @@
+#include <vector>
+
+#include "chunkHasher.h"
 #include "hashers.h"
 #include "index.h"
 #include "jsObjectParser.h"
 #include "jsUtils.h"
 
+template <uint32_t Variant>
 Napi::Value XxHashAddon::OneshotHash(const Napi::CallbackInfo& info) {
   auto env = info.Env();
-  uint32_t variant = GetVariantData(info);
 
   RawSizedArray data;
-  uint64_t seed = 0;
+  HashKey key;
 
   switch (info.Length()) {
     case 2:
-      seed = JsParseSeedArgument(env, variant, info[1]);
+      key = JsParseHashKeyArgument(env, Variant, info[1]);
     case 1:
       data = JsParseArgument<RawSizedArray>(env, info[0], "data");
       break;
@@ -20,7 +23,265 @@ Napi::Value XxHashAddon::OneshotHash(const Napi::CallbackInfo& info) {
       throw Napi::Error::New(env, "Wrong number of arguments");
   }
 
-  auto result = XxHashDynamicState::Oneshot(variant, data.data, data.length, seed);
+  auto result = OneshotHashOf<Variant>(data.data, data.length, key);
+
+  return JsParseHashResult(env, Variant, result);
+}
+
+template <uint32_t Variant>
+Napi::Value XxHashAddon::OneshotStringHash(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  // (data, seed?)
+  if (info.Length() < 1 || info.Length() > 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  JsUtf8Encoder encoder;
+  RawSizedArray data;
+
+  if (!encoder.Encode(env, info[0], data)) {
+    JsValueParseContext(env, "data", "parameter").InvalidType("string");
+  }
+
+  HashKey key = JsParseHashKeyArgument(env, Variant, info[1]);
+  auto result = OneshotHashOf<Variant>(data.data, data.length, key);
+
+  return JsParseHashResult(env, Variant, result);
+}
+
+template <uint32_t Variant>
+Napi::Value XxHashAddon::StringsHash(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  // (strings, seed?, out?)
+  if (info.Length() < 1 || info.Length() > 3) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  if (!info[0].IsArray()) {
+    JsValueParseContext(env, "strings", "parameter").InvalidType("array");
+  }
+
+  auto strings = info[0].As<Napi::Array>();
+  size_t count = strings.Length();
+
+  // Reading an element may run arbitrary JS (a getter or a proxy), which could
+  // detach the secret or out. The key gets a copy of the secret, each string
+  // is hashed right after it's read and out is resolved afterwards.
+  HashKey key = JsParseHashKeyArgument(env, Variant, info[1]).Own();
+  std::vector<GenericHashResult> hashes;
+  hashes.reserve(count);
+
+  // The heap buffer of the encoder is shared by all the long strings.
+  JsUtf8Encoder encoder;
+
+  for (size_t i = 0; i < count; i++) {
+    RawSizedArray data;
+
+    if (!encoder.Encode(env, strings.Get(i), data)) {
+      JsValueParseContext(env, "strings", "parameter")
+          .InvalidValue("an array of strings");
+    }
+
+    hashes.push_back(OneshotHashOf<Variant>(data.data, data.length, key));
+  }
+
+  Napi::Value out = info[2];
+  if (out.IsUndefined()) {
+    out = JsCreateHashResultArray(env, Variant, count);
+  }
+
+  uint8_t* results = JsParseHashResultArray(env, Variant, out, count, "out");
+  size_t resultSize = GetHashResultSize(Variant);
+
+  for (size_t i = 0; i < count; i++) {
+    StoreHashResult(Variant, hashes[i], results + i * resultSize);
+  }
+
+  return out;
+}
+
+Napi::Value XxHashAddon::OneshotHashAsync(const Napi::CallbackInfo& info) {
+  // Hashes the buffer on a worker thread, the buffer is kept alive until then.
+  class OneshotWorker : public Napi::AsyncWorker {
+   public:
+    OneshotWorker(uint32_t variant, Napi::Object buffer, RawSizedArray data,
+                  HashKey key, Napi::Function callback)
+        : Napi::AsyncWorker(callback),
+          _variant(variant),
+          _input(buffer, data),
+          _key(key) {}
+
+    void Execute() {
+      _result = XxHashDynamicState::Oneshot(_variant, _input.Data(),
+                                            _input.Length(), _key);
+    }
+
+    void OnOK() {
+      auto env = Env();
+      auto jsResult = JsParseHashResult(env, _variant, _result);
+
+      Callback().Call({env.Undefined(), jsResult});
+    }
+
+   private:
+    uint32_t _variant;
+    JsAsyncInput _input;
+    HashKey _key;
+
+    GenericHashResult _result;
+  };
+
+  auto env = info.Env();
+  uint32_t variant = GetVariantData(info);
+
+  // (data, seed, callback)
+  if (info.Length() != 3) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  auto callback = JsParseArgument<Napi::Function>(env, info[2], "callback");
+  auto data = JsParseArgument<RawSizedArray>(env, info[0], "data");
+  HashKey key = JsParseHashKeyArgument(env, variant, info[1]).Own();
 
-  return JsParseHashResult(env, variant, result);
+  auto worker = new OneshotWorker(variant, info[0].As<Napi::Object>(), data,
+                                  key, callback);
+  worker->Queue();
+
+  return env.Undefined();
+}
+
+template <uint32_t Variant>
+Napi::Value XxHashAddon::OneshotHashInto(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  constexpr uint32_t variant = Variant;
+
+  // (data, seed, out, offset?)
+  if (info.Length() < 3 || info.Length() > 4) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  auto data = JsParseArgument<RawSizedArray>(env, info[0], "data");
+  HashKey key = JsParseHashKeyArgument(env, variant, info[1]);
+  uint8_t* destination =
+      JsParseHashResultDestination(env, variant, info[2], info[3]);
+
+  auto result = OneshotHashOf<Variant>(data.data, data.length, key);
+  StoreHashResult(variant, result, destination);
+
+  return env.Undefined();
 }
+
+template <uint32_t Variant>
+Napi::Value XxHashAddon::OneshotBatchHash(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  constexpr uint32_t variant = Variant;
+
+  if (info.Length() < 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  // Either (buffers, seed?, out?) or (data, offsets, seed?, out?).
+  bool isBufferList = info[0].IsArray();
+  size_t argumentCount = isBufferList ? 3 : 4;
+
+  if (info.Length() > argumentCount) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  Napi::Array buffers;
+  RawSizedArray data;
+  const uint32_t* offsets = nullptr;
+  size_t count;
+
+  if (isBufferList) {
+    buffers = info[0].As<Napi::Array>();
+    count = buffers.Length();
+  } else {
+    data = JsParseArgument<RawSizedArray>(env, info[0], "data");
+    auto offsetArray =
+        JsParseArgument<Napi::Uint32Array>(env, info[1], "offsets");
+
+    offsets = offsetArray.Data();
+    size_t offsetCount = offsetArray.ElementLength();
+    count = offsetCount > 0 ? offsetCount - 1 : 0;
+
+    for (size_t i = 0; i < offsetCount; i++) {
+      bool isOrdered = i == 0 || offsets[i - 1] <= offsets[i];
+
+      if (!isOrdered || offsets[i] > data.length) {
+        JsValueParseContext(env, "offsets", "parameter")
+            .InvalidValue("non-decreasing and within the data");
+      }
+    }
+  }
+
+  size_t seedIndex = argumentCount - 2;
+  HashKey key = JsParseHashKeyArgument(env, variant, info[seedIndex]);
+  std::vector<GenericHashResult> listResults;
+
+  if (isBufferList) {
+    // Reading an element may run arbitrary JS (a getter or a proxy), which
+    // could detach the secret or out. The key gets a copy of the secret, each
+    // buffer is hashed right after it's read and out is resolved afterwards.
+    key = key.Own();
+    listResults.reserve(count);
+
+    for (size_t i = 0; i < count; i++) {
+      auto buffer = JsParseArgument<RawSizedArray>(env, buffers.Get(i), "data");
+
+      listResults.push_back(
+          OneshotHashOf<Variant>(buffer.data, buffer.length, key));
+    }
+  }
+
+  Napi::Value out = info[seedIndex + 1];
+  if (out.IsUndefined()) {
+    out = JsCreateHashResultArray(env, variant, count);
+  }
+
+  uint8_t* results = JsParseHashResultArray(env, variant, out, count, "out");
+  size_t resultSize = GetHashResultSize(variant);
+
+  for (size_t i = 0; i < count; i++) {
+    GenericHashResult result;
+
+    if (isBufferList) {
+      result = listResults[i];
+    } else {
+      // Item i is [offsets[i], offsets[i + 1]).
+      result = OneshotHashOf<Variant>(data.data + offsets[i],
+                                      offsets[i + 1] - offsets[i], key);
+    }
+
+    StoreHashResult(variant, result, results + i * resultSize);
+  }
+
+  return out;
+}
+
+Napi::Value XxHashAddon::OneshotChunksHash(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+  uint32_t variant = GetVariantData(info);
+
+  if (info.Length() != 2) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  auto data = JsParseArgument<RawSizedArray>(env, info[0], "data");
+  auto options = JsParseArgument<Napi::Object>(env, info[1], "options");
+  HashKey key = JsParseHashKeyProperty(env, variant, options);
+
+  auto chunker = CreateChunker(JsParseChunkingOptions(env, options));
+  ChunkHasher hasher(variant, key, *chunker);
+  hasher.Update(data.data, data.length);
+
+  return JsCreateChunkList(env, variant, hasher.Finish());
+}
+
+INSTANTIATE_VARIANT_METHOD(OneshotHash);
+INSTANTIATE_VARIANT_METHOD(OneshotStringHash);
+INSTANTIATE_VARIANT_METHOD(OneshotHashInto);
+INSTANTIATE_VARIANT_METHOD(OneshotBatchHash);
+INSTANTIATE_VARIANT_METHOD(StringsHash);
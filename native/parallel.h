@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Returns the number of threads to use for processing itemCount items.
+// requestedCount == 0 means "use all hardware threads".
+inline uint32_t ResolveConcurrency(uint32_t requestedCount, size_t itemCount) {
+  uint32_t count = requestedCount;
+
+  if (count == 0) {
+    count = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  return (uint32_t)std::max(std::min((size_t)count, itemCount), (size_t)1);
+}
+
+// Calls run() on threadCount threads, the calling thread included.
+//
+// The first exception is rethrown on the calling thread once all the threads
+// have finished.
+template <typename Run>
+void ParallelRun(uint32_t threadCount, Run run) {
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto runSafe = [&]() {
+    try {
+      run();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(errorMutex);
+
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(threadCount > 0 ? threadCount - 1 : 0);
+
+  for (uint32_t i = 1; i < threadCount; i++) {
+    try {
+      threads.emplace_back(runSafe);
+    } catch (const std::system_error&) {
+      // Out of threads - go on with the ones that were created.
+      break;
+    }
+  }
+
+  runSafe();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Hands out indices in [0, itemCount) to several threads. After Fail() is
+// called no new indices are handed out.
+class ParallelQueue {
+ public:
+  ParallelQueue(size_t itemCount) : _itemCount(itemCount) {}
+
+  bool Next(size_t& index) {
+    if (_failed.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    index = _nextIndex.fetch_add(1, std::memory_order_relaxed);
+
+    return index < _itemCount;
+  }
+
+  void Fail() { _failed = true; }
+
+ private:
+  size_t _itemCount;
+  std::atomic<size_t> _nextIndex{0};
+  std::atomic<bool> _failed{false};
+};
+
+// Calls body(context, index) for every index in [0, itemCount) on threadCount
+// threads, the calling thread included. Each thread creates its own context
+// with createContext(), so expensive per-thread resources are reused between
+// items.
+//
+// After the first exception no new items are handed out; the exception is
+// rethrown on the calling thread once all the threads have finished.
+template <typename CreateContext, typename Body>
+void ParallelFor(size_t itemCount, uint32_t threadCount,
+                 CreateContext createContext, Body body) {
+  ParallelQueue queue(itemCount);
+
+  ParallelRun(threadCount, [&]() {
+    try {
+      auto context = createContext();
+      size_t index;
+
+      while (queue.Next(index)) {
+        body(context, index);
+      }
+    } catch (...) {
+      queue.Fail();
+      throw;
+    }
+  });
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "handle.h"
+
+// How the hashed part of a file is going to be accessed. The hints are
+// advisory: they are ignored where the platform doesn't support them.
+enum class AccessPattern {
+  // No hints, the default behaviour of the OS.
+  Normal,
+
+  // The file is read once from the beginning to the end - the OS reads ahead
+  // aggressively (MADV_SEQUENTIAL, MADV_WILLNEED, POSIX_FADV_SEQUENTIAL).
+  Sequential,
+
+  // Like Sequential, and the whole mapping is faulted in at once with
+  // MAP_POPULATE / POSIX_FADV_WILLNEED.
+  Populate,
+
+  // Like Sequential, and the pages of the file are dropped from the page cache
+  // after they're hashed, so that hashing a large file doesn't evict other
+  // cached data.
+  NoReuse
+};
+
+// Tells the OS how the range of a regular file is going to be read.
+inline void AdviseFileAccess(FileHandle& handle, size_t offset, size_t length,
+                             AccessPattern pattern) {
+#ifdef POSIX_FADV_SEQUENTIAL
+  if (pattern == AccessPattern::Normal) {
+    return;
+  }
+
+  // 0 means "to the end of the file".
+  off_t adviceLength = length > (size_t)INT64_MAX ? 0 : (off_t)length;
+
+  posix_fadvise(handle, (off_t)offset, adviceLength, POSIX_FADV_SEQUENTIAL);
+
+  if (pattern == AccessPattern::Populate) {
+    posix_fadvise(handle, (off_t)offset, adviceLength, POSIX_FADV_WILLNEED);
+  }
+#endif
+}
+
+// Tells the OS that the range of a regular file was processed and its pages
+// are not going to be needed.
+inline void AdviseFileDone(FileHandle& handle, size_t offset, size_t length,
+                           AccessPattern pattern) {
+#ifdef POSIX_FADV_DONTNEED
+  if (pattern == AccessPattern::NoReuse && length > 0) {
+    // Only whole pages are dropped, so the range is extended to the beginning
+    // of the page which was partially read by the previous block.
+    size_t pageMask = (size_t)sysconf(_SC_PAGESIZE) - 1;
+    size_t begin = offset & ~pageMask;
+
+    posix_fadvise(handle, (off_t)begin, (off_t)(offset + length - begin),
+                  POSIX_FADV_DONTNEED);
+  }
+#endif
+}
@@ -7,11 +7,14 @@
 #include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <system_error>
 
 #include "platformError.h"
 
 #undef min
+#undef max
 
 BlockReader::~BlockReader() {
   if (_buffer != nullptr) {
@@ -19,9 +22,43 @@ BlockReader::~BlockReader() {
   }
 }
 
-void BlockReader::Open(const NativeString& path, size_t offset, size_t length) {
-  const uint32_t MAX_BUFFER_SIZE = 4096;
+// Makes sure the buffer can hold at least size bytes. The contents are not
+// preserved.
+static void EnsureBufferSize(uint8_t*& buffer, uint32_t& capacity,
+                             uint32_t size) {
+  if (buffer == nullptr || size > capacity) {
+    free(buffer);
+
+    buffer = (uint8_t*)malloc(size);
+    capacity = 0;
+
+    CHECK_PLATFORM_ERROR(buffer == nullptr);
 
+    capacity = size;
+  }
+}
+
+uint32_t BlockReader::SelectBlockSize(uint32_t blockSize, bool isRegularFile,
+                                      size_t expectedLength) {
+  size_t size = blockSize;
+
+  if (size == 0) {
+    if (!isRegularFile) {
+      size = BlockReader::DEFAULT_BLOCK_SIZE;
+    } else if (expectedLength < BlockReader::LARGE_FILE_SIZE) {
+      size = BlockReader::MEDIUM_BLOCK_SIZE;
+    } else {
+      size = BlockReader::LARGE_BLOCK_SIZE;
+    }
+  }
+
+  // There's no sense in allocating more than we're going to read. But the
+  // block should be non-empty, otherwise ReadBlock() would never progress.
+  return (uint32_t)std::max(std::min(size, expectedLength), (size_t)1);
+}
+
+void BlockReader::Open(const NativeString& path, size_t offset, size_t length,
+                       uint32_t blockSize, AccessPattern pattern) {
   FileHandle handle = FileHandle::OpenRead(path);
   CHECK_PLATFORM_ERROR(handle.IsInvalid());
 
@@ -34,7 +71,10 @@ void BlockReader::Open(const NativeString& path, size_t offset, size_t length) {
         !SetFilePointerEx(handle, largeOffset, NULL, FILE_BEGIN));
   }
 
-  auto prefBufferSize = (uint32_t)std::min((size_t)MAX_BUFFER_SIZE, length);
+  LARGE_INTEGER largeFileSize;
+  bool isRegularFile = GetFileType(handle) == FILE_TYPE_DISK &&
+                       GetFileSizeEx(handle, &largeFileSize);
+  uint64_t fileSize = isRegularFile ? (uint64_t)largeFileSize.QuadPart : 0;
 #else
   if (offset != 0) {
     CHECK_PLATFORM_ERROR(lseek(handle, offset, SEEK_SET) < 0)
@@ -43,52 +83,169 @@ void BlockReader::Open(const NativeString& path, size_t offset, size_t length) {
   struct stat fileStat;
   CHECK_PLATFORM_ERROR(fstat(handle, &fileStat) < 0)
 
-  auto prefBufferSize = std::min((size_t)fileStat.st_blksize, length);
+  bool isRegularFile = S_ISREG(fileStat.st_mode);
+  uint64_t fileSize = (uint64_t)fileStat.st_size;
 #endif
 
-  uint8_t* buffer = _buffer;
+  size_t expectedLength = length;
 
-  if (buffer == nullptr) {
-    buffer = (uint8_t*)malloc(prefBufferSize);
-    _bufferSize = prefBufferSize;
+  if (isRegularFile) {
+    size_t available = offset < fileSize ? (size_t)(fileSize - offset) : 0;
+    expectedLength = std::min(length, available);
 
-  } else if (prefBufferSize > _bufferSize) {
-    free(buffer);
-
-    buffer = (uint8_t*)malloc(MAX_BUFFER_SIZE);
-    _bufferSize = MAX_BUFFER_SIZE;
+    AdviseFileAccess(handle, offset, expectedLength, pattern);
   }
 
-  CHECK_PLATFORM_ERROR(buffer == nullptr);
-
-  _buffer = buffer;
+  _blockSize = SelectBlockSize(blockSize, isRegularFile, expectedLength);
+  _expectedLength = expectedLength;
   _handle = std::move(handle);
 
   _offset = 0;
   _length = length;
+
+  _fileOffset = offset;
+  _isRegularFile = isRegularFile;
+  _pattern = pattern;
 }
 
 Block BlockReader::ReadBlock() {
-  size_t bytesToRead = std::min((size_t)_bufferSize, _length - _offset);
+  EnsureBufferSize(_buffer, _bufferSize, _blockSize);
+
+  return ReadBlock(_buffer);
+}
+
+Block BlockReader::ReadBlock(uint8_t* buffer) {
+  size_t bytesToRead = std::min((size_t)_blockSize, _length - _offset);
 
 #ifdef _WIN32
   DWORD bytesRead;
   bool result =
-      ReadFile(_handle, _buffer, (DWORD)bytesToRead, &bytesRead, NULL);
+      ReadFile(_handle, buffer, (DWORD)bytesToRead, &bytesRead, NULL);
 
   if (!result) {
     ThrowPlatformException();
   }
 #else
-  ssize_t bytesRead = read(_handle, _buffer, bytesToRead);
+  ssize_t bytesRead = read(_handle, buffer, bytesToRead);
   if (bytesRead < 0) {
     ThrowPlatformException();
   }
 #endif
 
+  if (_isRegularFile) {
+    AdviseFileDone(_handle, _fileOffset + _offset, (size_t)bytesRead,
+                   _pattern);
+  }
+
   _offset += bytesRead;
 
-  return {_buffer, (uint32_t)bytesRead};
+  return {buffer, (size_t)bytesRead};
+}
+
+ReadAheadBlockReader::~ReadAheadBlockReader() {
+  Stop();
+
+  for (auto& slot : _slots) {
+    free(slot.buffer);
+  }
+}
+
+bool ReadAheadBlockReader::Start(BlockReader& reader) {
+  Stop();
+
+  for (auto& slot : _slots) {
+    EnsureBufferSize(slot.buffer, slot.capacity, reader.GetBlockSize());
+
+    slot.length = 0;
+    slot.filled = false;
+  }
+
+  _nextSlot = 0;
+  _hasCurrent = false;
+  _stopped = false;
+  _error = nullptr;
+
+  try {
+    _thread = std::thread(&ReadAheadBlockReader::ReadLoop, this, &reader);
+  } catch (const std::system_error&) {
+    return false;
+  }
+
+  return true;
+}
+
+void ReadAheadBlockReader::Stop() {
+  if (_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stopped = true;
+    }
+
+    _condition.notify_all();
+    _thread.join();
+  }
+}
+
+void ReadAheadBlockReader::ReadLoop(BlockReader* reader) {
+  for (int index = 0;; index = (index + 1) % SLOT_COUNT) {
+    Slot& slot = _slots[index];
+
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [&] { return !slot.filled || _stopped; });
+
+      if (_stopped) {
+        return;
+      }
+    }
+
+    size_t length = 0;
+    std::exception_ptr error;
+
+    try {
+      length = reader->ReadBlock(slot.buffer).length;
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+
+      slot.length = length;
+      slot.filled = true;
+      _error = error;
+    }
+
+    _condition.notify_all();
+
+    // The consumer gets an empty block at the end of the file or on error.
+    if (length == 0) {
+      return;
+    }
+  }
+}
+
+Block ReadAheadBlockReader::ReadBlock() {
+  std::unique_lock<std::mutex> lock(_mutex);
+
+  if (_hasCurrent) {
+    // The consumer is done with the previous block, so its buffer can be
+    // filled again.
+    _slots[(_nextSlot + SLOT_COUNT - 1) % SLOT_COUNT].filled = false;
+    _condition.notify_all();
+  }
+
+  Slot& slot = _slots[_nextSlot];
+  _condition.wait(lock, [&] { return slot.filled; });
+
+  _nextSlot = (_nextSlot + 1) % SLOT_COUNT;
+  _hasCurrent = true;
+
+  if (_error) {
+    std::rethrow_exception(_error);
+  }
+
+  return {slot.buffer, slot.length};
 }
 
 AsyncBlockReader::~AsyncBlockReader() {
@@ -2,12 +2,17 @@
 
 #include <uv.h>
 
+#include <condition_variable>
 #include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
+#include "accessPattern.h"
 #include "handle.h"
 #include "nativeString.h"
 
@@ -23,21 +28,105 @@ struct Block {
 // reading without the re-allocation of buffers.
 class BlockReader {
  public:
+  // Block size used for non-regular files (pipes, devices) when the block size
+  // is not specified.
+  static constexpr uint32_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  // Files smaller than LARGE_FILE_SIZE are read with blocks of at most
+  // MEDIUM_BLOCK_SIZE, larger ones - with LARGE_BLOCK_SIZE.
+  static constexpr uint32_t MEDIUM_BLOCK_SIZE = 256 * 1024;
+  static constexpr uint32_t LARGE_BLOCK_SIZE = 1024 * 1024;
+  static constexpr size_t LARGE_FILE_SIZE = 16 * 1024 * 1024;
+
+  // Largest block size that can be requested explicitly.
+  static constexpr uint32_t MAX_BLOCK_SIZE = 64 * 1024 * 1024;
+
+  // Resolves the requested block size (0 - adaptive) for a file of which
+  // expectedLength bytes are going to be read.
+  static uint32_t SelectBlockSize(uint32_t blockSize, bool isRegularFile,
+                                  size_t expectedLength);
+
   BlockReader() {}
   ~BlockReader();
 
-  void Open(const NativeString& path, size_t offset, size_t length);
+  // blockSize is the preferred size of a block, 0 selects it based on the
+  // size of the file.
+  void Open(const NativeString& path, size_t offset, size_t length,
+            uint32_t blockSize = 0,
+            AccessPattern pattern = AccessPattern::Sequential);
 
+  // Reads a block to the internal buffer, which is allocated on the first call.
   Block ReadBlock();
 
+  // Reads a block to the given buffer that should be able to hold at least
+  // GetBlockSize() bytes.
+  Block ReadBlock(uint8_t* buffer);
+
+  uint32_t GetBlockSize() const { return _blockSize; }
+
+  // Number of bytes that are expected to be read, if known. For non-regular
+  // files it's the requested length.
+  size_t GetExpectedLength() const { return _expectedLength; }
+
+  bool IsRegularFile() const { return _isRegularFile; }
+
  private:
   FileHandle _handle;
 
   uint8_t* _buffer = nullptr;
   uint32_t _bufferSize = 0;
+  uint32_t _blockSize = 0;
 
   size_t _offset = 0;
   size_t _length = 0;
+  size_t _expectedLength = 0;
+
+  // Used to drop the pages that were read from the page cache.
+  size_t _fileOffset = 0;
+  bool _isRegularFile = false;
+  AccessPattern _pattern = AccessPattern::Normal;
+};
+
+// Reads blocks of a BlockReader on a background thread one block ahead of the
+// consumer, so reading the next block overlaps with processing the current one.
+// Like BlockReader, it's reusable and keeps its buffers between files.
+class ReadAheadBlockReader {
+ public:
+  ReadAheadBlockReader() {}
+  ReadAheadBlockReader(const ReadAheadBlockReader& other) = delete;
+  ~ReadAheadBlockReader();
+
+  // Starts reading the opened reader. It should not be used by anyone else
+  // until ReadBlock() returns an empty block.
+  //
+  // Returns false if the background thread can't be started.
+  bool Start(BlockReader& reader);
+
+  // The returned block is valid until the next call.
+  Block ReadBlock();
+
+ private:
+  static constexpr int SLOT_COUNT = 2;
+
+  struct Slot {
+    uint8_t* buffer = nullptr;
+    uint32_t capacity = 0;
+    size_t length = 0;
+    bool filled = false;
+  };
+
+  Slot _slots[SLOT_COUNT];
+  int _nextSlot = 0;
+  bool _hasCurrent = false;
+
+  std::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stopped = false;
+  std::exception_ptr _error;
+
+  void ReadLoop(BlockReader* reader);
+  void Stop();
 };
 
 class AsyncBlockReader {
@@ -0,0 +1,287 @@
+#include "directory.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#include "handle.h"
+#include "platformError.h"
+
+namespace {
+
+enum class EntryType { Other, File, Directory };
+
+// (device, file index) pair that uniquely identifies a directory.
+using FileId = std::pair<uint64_t, uint64_t>;
+
+template <typename Char>
+bool IsDotEntry(const Char* name) {
+  return name[0] == '.' &&
+         (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+#ifndef _WIN32
+class DirectoryStream {
+ public:
+  DirectoryStream(DIR* dir) : _dir(dir) {}
+  DirectoryStream(const DirectoryStream& other) = delete;
+
+  ~DirectoryStream() {
+    if (_dir != nullptr) {
+      closedir(_dir);
+    }
+  }
+
+  operator DIR*() { return _dir; }
+
+ private:
+  DIR* _dir;
+};
+#endif
+
+class DirectoryWalker {
+ public:
+  DirectoryWalker(const NativeString& root, const DirectoryWalkOptions& options)
+      : _root(root), _options(options) {}
+
+  std::vector<NativeString> Walk() {
+    Visit(NativeString());
+
+    return std::move(_files);
+  }
+
+ private:
+  NativeString _root;
+  DirectoryWalkOptions _options;
+
+  std::vector<NativeString> _files;
+  // Directories on the path from the root to the one being visited. Only
+  // these are skipped, a directory reachable through several links is still
+  // listed under each of them.
+  std::set<FileId> _ancestors;
+
+  void Visit(const NativeString& relativePath) {
+    NativeString fullPath =
+        relativePath.empty() ? _root : JoinPath(_root, relativePath);
+    std::vector<NativeString> subdirectories;
+    FileId id;
+
+    if (!ReadDirectory(fullPath, relativePath, subdirectories, id)) {
+      return;
+    }
+
+    // The directory is closed at this point, so the number of open handles
+    // doesn't depend on the depth of the tree.
+    for (const auto& subdirectory : subdirectories) {
+      Visit(subdirectory);
+    }
+
+    if (_options.followSymlinks) {
+      _ancestors.erase(id);
+    }
+  }
+
+  void AddEntry(EntryType type, NativeString relativePath,
+                std::vector<NativeString>& subdirectories) {
+    switch (type) {
+      case EntryType::File:
+        _files.push_back(std::move(relativePath));
+        break;
+      case EntryType::Directory:
+        if (_options.recursive) {
+          subdirectories.push_back(std::move(relativePath));
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+#ifdef _WIN32
+  // Returns false if the directory is one of its own ancestors.
+  bool EnterDirectory(const NativeString& fullPath, FileId& id) {
+    FileHandle handle(CreateFileW((LPCWSTR)fullPath.c_str(), 0,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                      FILE_SHARE_DELETE,
+                                  NULL, OPEN_EXISTING,
+                                  FILE_FLAG_BACKUP_SEMANTICS, NULL));
+    CHECK_PLATFORM_ERROR(handle.IsInvalid())
+
+    BY_HANDLE_FILE_INFORMATION info;
+    CHECK_PLATFORM_ERROR(!GetFileInformationByHandle(handle, &info))
+
+    uint64_t index = ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+
+    id = {info.dwVolumeSerialNumber, index};
+
+    return _ancestors.insert(id).second;
+  }
+
+  static EntryType GetTypeByAttributes(DWORD attributes) {
+    if (attributes & FILE_ATTRIBUTE_DIRECTORY) {
+      return EntryType::Directory;
+    }
+
+    return (attributes & FILE_ATTRIBUTE_DEVICE) ? EntryType::Other
+                                                : EntryType::File;
+  }
+
+  EntryType GetEntryType(const NativeString& directoryPath,
+                         const WIN32_FIND_DATAW& data) {
+    DWORD attributes = data.dwFileAttributes;
+
+    if ((attributes & FILE_ATTRIBUTE_REPARSE_POINT) == 0) {
+      return GetTypeByAttributes(attributes);
+    }
+
+    if (!_options.followSymlinks) {
+      return EntryType::Other;
+    }
+
+    NativeString entryPath =
+        JoinPath(directoryPath, (const char16_t*)data.cFileName);
+
+    FileHandle handle(CreateFileW((LPCWSTR)entryPath.c_str(), 0,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE |
+                                      FILE_SHARE_DELETE,
+                                  NULL, OPEN_EXISTING,
+                                  FILE_FLAG_BACKUP_SEMANTICS, NULL));
+
+    BY_HANDLE_FILE_INFORMATION info;
+    if (handle.IsInvalid() || !GetFileInformationByHandle(handle, &info)) {
+      // Dangling link
+      return EntryType::Other;
+    }
+
+    return GetTypeByAttributes(info.dwFileAttributes);
+  }
+
+  bool ReadDirectory(const NativeString& fullPath,
+                     const NativeString& relativePath,
+                     std::vector<NativeString>& subdirectories, FileId& id) {
+    if (_options.followSymlinks && !EnterDirectory(fullPath, id)) {
+      return false;
+    }
+
+    NativeString pattern = JoinPath(fullPath, u"*");
+
+    WIN32_FIND_DATAW data;
+    HANDLE find =
+        FindFirstFileExW((LPCWSTR)pattern.c_str(), FindExInfoBasic, &data,
+                         FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    CHECK_PLATFORM_ERROR(find == INVALID_HANDLE_VALUE)
+
+    do {
+      auto name = (const char16_t*)data.cFileName;
+
+      if (IsDotEntry(name)) {
+        continue;
+      }
+
+      AddEntry(GetEntryType(fullPath, data), JoinPath(relativePath, name),
+               subdirectories);
+    } while (FindNextFileW(find, &data));
+
+    DWORD error = GetLastError();
+    FindClose(find);
+
+    if (error != ERROR_NO_MORE_FILES) {
+      throw PlatformException(error);
+    }
+
+    return true;
+  }
+#else
+  EntryType GetEntryType(int dirFd, const dirent* entry) {
+    struct stat entryStat;
+
+    switch (entry->d_type) {
+      case DT_REG:
+        return EntryType::File;
+      case DT_DIR:
+        return EntryType::Directory;
+      case DT_LNK:
+        if (!_options.followSymlinks ||
+            fstatat(dirFd, entry->d_name, &entryStat, 0) < 0) {
+          // Skipped or dangling link
+          return EntryType::Other;
+        }
+        break;
+      case DT_UNKNOWN:
+        // Some file systems don't fill d_type.
+        if (fstatat(dirFd, entry->d_name, &entryStat,
+                    _options.followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW) < 0) {
+          return EntryType::Other;
+        }
+        break;
+      default:
+        return EntryType::Other;
+    }
+
+    if (S_ISREG(entryStat.st_mode)) {
+      return EntryType::File;
+    }
+
+    return S_ISDIR(entryStat.st_mode) ? EntryType::Directory
+                                      : EntryType::Other;
+  }
+
+  bool ReadDirectory(const NativeString& fullPath,
+                     const NativeString& relativePath,
+                     std::vector<NativeString>& subdirectories, FileId& id) {
+    DirectoryStream dir(opendir(fullPath.c_str()));
+    CHECK_PLATFORM_ERROR(dir == nullptr)
+
+    int dirFd = dirfd(dir);
+
+    if (_options.followSymlinks) {
+      struct stat dirStat;
+      CHECK_PLATFORM_ERROR(fstat(dirFd, &dirStat) < 0)
+
+      id = {dirStat.st_dev, dirStat.st_ino};
+
+      if (!_ancestors.insert(id).second) {
+        return false;
+      }
+    }
+
+    while (true) {
+      errno = 0;
+      dirent* entry = readdir(dir);
+
+      if (entry == nullptr) {
+        CHECK_PLATFORM_ERROR(errno != 0)
+        break;
+      }
+
+      if (IsDotEntry(entry->d_name)) {
+        continue;
+      }
+
+      AddEntry(GetEntryType(dirFd, entry),
+               JoinPath(relativePath, entry->d_name), subdirectories);
+    }
+
+    return true;
+  }
+#endif
+};
+
+}  // namespace
+
+std::vector<NativeString> ListDirectoryFiles(
+    const NativeString& path, const DirectoryWalkOptions& options) {
+  DirectoryWalker walker(path, options);
+
+  return walker.Walk();
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "nativeString.h"
+
+struct DirectoryWalkOptions {
+  bool recursive;
+  bool followSymlinks;
+
+  DirectoryWalkOptions(bool recursive, bool followSymlinks)
+      : recursive(recursive), followSymlinks(followSymlinks) {}
+};
+
+#ifdef _WIN32
+constexpr NativeChar PATH_SEPARATOR = u'\\';
+#else
+constexpr NativeChar PATH_SEPARATOR = '/';
+#endif
+
+// Collects paths of the regular files in the directory, relative to it.
+// Symbolic links are skipped unless followSymlinks is set, in which case the
+// link's target is used. A link to a directory that is being walked is
+// skipped to break cycles; other directories are listed once per link.
+//
+// Throws PlatformException if a directory can't be read.
+std::vector<NativeString> ListDirectoryFiles(
+    const NativeString& path, const DirectoryWalkOptions& options);
+
+inline NativeString JoinPath(const NativeString& directory,
+                             const NativeString& name) {
+  if (directory.empty()) {
+    return name;
+  }
+
+  NativeString result;
+  result.reserve(directory.size() + name.size() + 1);
+  result.append(directory);
+
+  if (directory.back() != PATH_SEPARATOR && directory.back() != '/') {
+    result.push_back(PATH_SEPARATOR);
+  }
+
+  result.append(name);
+
+  return result;
+}
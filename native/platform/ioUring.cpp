@@ -0,0 +1,513 @@
+#include "ioUring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "handle.h"
+#include "platformError.h"
+
+#undef min
+#undef max
+
+#ifdef HAS_IO_URING
+
+// Minimal io_uring wrapper on top of the raw system calls, so that liburing is
+// not required to build the addon.
+class IoUring {
+ public:
+  IoUring() {}
+  IoUring(const IoUring& other) = delete;
+
+  ~IoUring() {
+    if (_sqes != MAP_FAILED) {
+      munmap(_sqes, _sqesSize);
+    }
+
+    if (_rings != MAP_FAILED) {
+      munmap(_rings, _ringsSize);
+    }
+
+    if (_fd >= 0) {
+      close(_fd);
+    }
+  }
+
+  bool Init(uint32_t entries) {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // Fails with ENOSYS on old kernels, EPERM when io_uring is disabled by
+    // sysctl or seccomp, ENOMEM when RLIMIT_MEMLOCK is too low.
+    _fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (_fd < 0) {
+      return false;
+    }
+
+    // IORING_OP_READ is available since the same kernel (5.6) as
+    // IORING_FEAT_RW_CUR_POS.
+    uint32_t requiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_RW_CUR_POS;
+    if ((params.features & requiredFeatures) != requiredFeatures) {
+      return false;
+    }
+
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cqSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    _ringsSize = std::max(sqSize, cqSize);
+    _rings = mmap(nullptr, _ringsSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+    if (_rings == MAP_FAILED) {
+      return false;
+    }
+
+    _sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    _sqes = mmap(nullptr, _sqesSize, PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES);
+    if (_sqes == MAP_FAILED) {
+      return false;
+    }
+
+    auto rings = (uint8_t*)_rings;
+
+    _sqHead = (uint32_t*)(rings + params.sq_off.head);
+    _sqTail = (uint32_t*)(rings + params.sq_off.tail);
+    _sqMask = *(uint32_t*)(rings + params.sq_off.ring_mask);
+    _sqArray = (uint32_t*)(rings + params.sq_off.array);
+    _sqEntries = params.sq_entries;
+    _localSqTail = *_sqTail;
+
+    _cqHead = (uint32_t*)(rings + params.cq_off.head);
+    _cqTail = (uint32_t*)(rings + params.cq_off.tail);
+    _cqMask = *(uint32_t*)(rings + params.cq_off.ring_mask);
+    _cqes = (io_uring_cqe*)(rings + params.cq_off.cqes);
+
+    return true;
+  }
+
+  // Returns false if the submission queue is full.
+  bool QueueRead(int fd, void* buffer, uint32_t length, uint64_t offset,
+                 uint64_t userData) {
+    uint32_t head = __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE);
+    if (_localSqTail - head >= _sqEntries) {
+      return false;
+    }
+
+    uint32_t index = _localSqTail & _sqMask;
+    io_uring_sqe* sqe = (io_uring_sqe*)_sqes + index;
+
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)buffer;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = userData;
+
+    _sqArray[index] = index;
+    _localSqTail++;
+    _unsubmitted++;
+
+    return true;
+  }
+
+  // Submits the queued reads and waits until at least waitCount of the reads
+  // are completed.
+  void Submit(uint32_t waitCount) {
+    __atomic_store_n(_sqTail, _localSqTail, __ATOMIC_RELEASE);
+
+    while (true) {
+      int result = (int)syscall(__NR_io_uring_enter, _fd, _unsubmitted,
+                                waitCount,
+                                waitCount > 0 ? IORING_ENTER_GETEVENTS : 0,
+                                nullptr, 0);
+
+      if (result >= 0) {
+        _unsubmitted -= (uint32_t)result;
+        return;
+      }
+
+      if (errno == EAGAIN || errno == EBUSY) {
+        // The kernel is short of resources or the completion queue is full -
+        // the caller will reap the completions and try again.
+        return;
+      }
+
+      CHECK_PLATFORM_ERROR(errno != EINTR)
+    }
+  }
+
+  template <typename Callback>
+  void ForEachCompletion(Callback callback) {
+    uint32_t head = *_cqHead;
+    uint32_t tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++) {
+      const io_uring_cqe& cqe = _cqes[head & _cqMask];
+
+      callback(cqe.user_data, cqe.res);
+    }
+
+    __atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+  }
+
+ private:
+  int _fd = -1;
+
+  void* _rings = MAP_FAILED;
+  size_t _ringsSize = 0;
+  void* _sqes = MAP_FAILED;
+  size_t _sqesSize = 0;
+
+  uint32_t* _sqHead = nullptr;
+  uint32_t* _sqTail = nullptr;
+  uint32_t* _sqArray = nullptr;
+  uint32_t _sqMask = 0;
+  uint32_t _sqEntries = 0;
+  uint32_t _localSqTail = 0;
+  uint32_t _unsubmitted = 0;
+
+  uint32_t* _cqHead = nullptr;
+  uint32_t* _cqTail = nullptr;
+  uint32_t _cqMask = 0;
+  io_uring_cqe* _cqes = nullptr;
+};
+
+enum class ReadState { Free, InFlight, Ready, Stale };
+
+struct ReadSlot {
+  uint8_t* buffer = nullptr;
+  uint32_t capacity = 0;
+
+  ReadState state = ReadState::Free;
+  uint32_t requested = 0;
+  int32_t result = 0;
+};
+
+struct IoUringBatchReader::FileSlot {
+  FileHandle handle;
+  bool active = false;
+  bool ended = false;
+
+  // Non-regular files are read one block at a time at the current position.
+  bool isRegularFile = false;
+  AccessPattern pattern = AccessPattern::Normal;
+  uint32_t depth = 1;
+  uint32_t blockSize = 0;
+
+  size_t offset = 0;
+  size_t expectedLength = 0;
+  size_t readPosition = 0;
+  size_t consumedPosition = 0;
+
+  // Reads are issued and consumed in the round-robin order of the slots.
+  uint32_t issueIndex = 0;
+  uint32_t consumeIndex = 0;
+  uint32_t inFlight = 0;
+
+  ReadSlot reads[READS_PER_FILE];
+
+  FileSlot() {}
+  FileSlot(const FileSlot& other) = delete;
+
+  ~FileSlot() {
+    for (auto& read : reads) {
+      free(read.buffer);
+    }
+  }
+};
+
+IoUringBatchReader::IoUringBatchReader() {}
+
+IoUringBatchReader::~IoUringBatchReader() {}
+
+bool IoUringBatchReader::Init() {
+  if (_ring) {
+    return true;
+  }
+
+  std::unique_ptr<IoUring> ring(new IoUring());
+  if (!ring->Init(MAX_OPEN_FILES * READS_PER_FILE)) {
+    return false;
+  }
+
+  _files.reset(new FileSlot[MAX_OPEN_FILES]);
+  _ring = std::move(ring);
+
+  return true;
+}
+
+void IoUringBatchReader::Run() {
+  try {
+    bool hasMoreFiles = true;
+
+    while (true) {
+      for (uint32_t slot = 0; slot < MAX_OPEN_FILES; slot++) {
+        if (hasMoreFiles && !_files[slot].active) {
+          hasMoreFiles = OpenNext(slot);
+        }
+
+        QueueReads(slot);
+      }
+
+      // Every file that is not finished has at least one read in flight.
+      if (_inFlight == 0) {
+        break;
+      }
+
+      _ring->Submit(1);
+      _ring->ForEachCompletion([this](uint64_t userData, int32_t result) {
+        HandleCompletion(userData, result);
+      });
+
+      for (uint32_t slot = 0; slot < MAX_OPEN_FILES; slot++) {
+        ConsumeReads(slot);
+      }
+    }
+  } catch (...) {
+    Drain();
+    throw;
+  }
+}
+
+bool IoUringBatchReader::OpenNext(uint32_t slot) {
+  FileSlot& file = _files[slot];
+  IoUringFileRequest request;
+
+  while (NextFile(slot, request)) {
+    FileHandle handle = FileHandle::OpenRead(*request.path);
+    CHECK_PLATFORM_ERROR(handle.IsInvalid())
+
+    struct stat fileStat;
+    CHECK_PLATFORM_ERROR(fstat(handle, &fileStat) < 0)
+
+    bool isRegularFile = S_ISREG(fileStat.st_mode);
+    size_t expectedLength = request.length;
+
+    if (isRegularFile) {
+      uint64_t fileSize = (uint64_t)fileStat.st_size;
+      size_t available =
+          request.offset < fileSize ? (size_t)(fileSize - request.offset) : 0;
+
+      expectedLength = std::min(request.length, available);
+
+      AdviseFileAccess(handle, request.offset, expectedLength, request.pattern);
+    } else if (request.offset != 0) {
+      CHECK_PLATFORM_ERROR(lseek(handle, request.offset, SEEK_SET) < 0)
+    }
+
+    if (expectedLength == 0) {
+      OnEnd(slot);
+      continue;
+    }
+
+    uint32_t blockSize = std::min(
+        BlockReader::SelectBlockSize(request.blockSize, isRegularFile,
+                                     expectedLength),
+        MAX_BLOCK_SIZE);
+
+    file.handle = std::move(handle);
+    file.active = true;
+    file.ended = false;
+    file.isRegularFile = isRegularFile;
+    file.pattern = request.pattern;
+    file.depth = isRegularFile ? READS_PER_FILE : 1;
+    file.blockSize = blockSize;
+    file.offset = request.offset;
+    file.expectedLength = expectedLength;
+    file.readPosition = 0;
+    file.consumedPosition = 0;
+    file.issueIndex = 0;
+    file.consumeIndex = 0;
+
+    return true;
+  }
+
+  return false;
+}
+
+void IoUringBatchReader::QueueReads(uint32_t slot) {
+  FileSlot& file = _files[slot];
+
+  if (!file.active) {
+    return;
+  }
+
+  while (!file.ended && file.readPosition < file.expectedLength) {
+    uint32_t readIndex = file.issueIndex % file.depth;
+    ReadSlot& read = file.reads[readIndex];
+
+    if (read.state != ReadState::Free) {
+      break;
+    }
+
+    if (read.buffer == nullptr || read.capacity < file.blockSize) {
+      free(read.buffer);
+
+      read.capacity = 0;
+      read.buffer = (uint8_t*)malloc(file.blockSize);
+      CHECK_PLATFORM_ERROR(read.buffer == nullptr)
+
+      read.capacity = file.blockSize;
+    }
+
+    uint32_t length = (uint32_t)std::min(
+        (size_t)file.blockSize, file.expectedLength - file.readPosition);
+
+    // -1 means the current position of the file.
+    uint64_t offset = file.isRegularFile
+                          ? (uint64_t)(file.offset + file.readPosition)
+                          : (uint64_t)-1;
+
+    if (!_ring->QueueRead(file.handle, read.buffer, length, offset,
+                          slot * READS_PER_FILE + readIndex)) {
+      break;
+    }
+
+    read.state = ReadState::InFlight;
+    read.requested = length;
+
+    file.readPosition += length;
+    file.issueIndex++;
+    file.inFlight++;
+    _inFlight++;
+  }
+}
+
+void IoUringBatchReader::HandleCompletion(uint64_t userData, int32_t result) {
+  FileSlot& file = _files[userData / READS_PER_FILE];
+  ReadSlot& read = file.reads[userData % READS_PER_FILE];
+
+  file.inFlight--;
+  _inFlight--;
+
+  if (read.state == ReadState::Stale) {
+    read.state = ReadState::Free;
+  } else {
+    read.state = ReadState::Ready;
+    read.result = result;
+  }
+
+  if (file.ended && file.inFlight == 0) {
+    Release(file);
+  }
+}
+
+void IoUringBatchReader::ConsumeReads(uint32_t slot) {
+  FileSlot& file = _files[slot];
+
+  while (file.active && !file.ended) {
+    ReadSlot& read = file.reads[file.consumeIndex % file.depth];
+
+    if (read.state != ReadState::Ready) {
+      break;
+    }
+
+    if (read.result < 0) {
+      throw PlatformException(-read.result);
+    }
+
+    read.state = ReadState::Free;
+    file.consumeIndex++;
+
+    size_t length = (size_t)read.result;
+
+    if (length > 0) {
+      OnBlock(slot, read.buffer, length);
+
+      if (file.isRegularFile) {
+        AdviseFileDone(file.handle, file.offset + file.consumedPosition,
+                       length, file.pattern);
+      }
+
+      file.consumedPosition += length;
+    }
+
+    if (length == 0 || file.consumedPosition >= file.expectedLength) {
+      file.ended = true;
+      OnEnd(slot);
+    } else if (length < read.requested) {
+      // Short read - the reads after this one don't continue the data. Drop
+      // them and read again from the current position.
+      for (uint32_t i = file.consumeIndex; i != file.issueIndex; i++) {
+        ReadSlot& laterRead = file.reads[i % file.depth];
+
+        laterRead.state = laterRead.state == ReadState::InFlight
+                              ? ReadState::Stale
+                              : ReadState::Free;
+      }
+
+      file.issueIndex = file.consumeIndex;
+      file.readPosition = file.consumedPosition;
+    }
+  }
+
+  if (file.active && file.ended && file.inFlight == 0) {
+    Release(file);
+  }
+}
+
+void IoUringBatchReader::Release(FileSlot& file) {
+  file.handle = FileHandle();
+  file.active = false;
+
+  for (auto& read : file.reads) {
+    read.state = ReadState::Free;
+  }
+}
+
+void IoUringBatchReader::Drain() {
+  try {
+    while (_inFlight > 0) {
+      _ring->Submit(1);
+      _ring->ForEachCompletion([this](uint64_t userData, int32_t) {
+        _files[userData / READS_PER_FILE].inFlight--;
+        _inFlight--;
+      });
+    }
+  } catch (...) {
+    // The kernel may still write to the buffers of the reads that are in
+    // flight, so they can't be freed.
+    for (uint32_t slot = 0; slot < MAX_OPEN_FILES; slot++) {
+      for (auto& read : _files[slot].reads) {
+        read.buffer = nullptr;
+      }
+    }
+
+    _files.reset();
+    _ring.reset();
+    _inFlight = 0;
+
+    return;
+  }
+
+  for (uint32_t slot = 0; slot < MAX_OPEN_FILES; slot++) {
+    Release(_files[slot]);
+  }
+}
+
+#else
+
+class IoUring {};
+
+struct IoUringBatchReader::FileSlot {};
+
+IoUringBatchReader::IoUringBatchReader() {}
+
+IoUringBatchReader::~IoUringBatchReader() {}
+
+bool IoUringBatchReader::Init() { return false; }
+
+void IoUringBatchReader::Run() {}
+
+#endif
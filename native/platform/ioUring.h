@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "accessPattern.h"
+#include "blockReader.h"
+#include "nativeString.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HAS_IO_URING 1
+#endif
+#endif
+
+struct IoUringFileRequest {
+  const NativeString* path;
+  size_t offset;
+  size_t length;
+
+  // 0 - adaptive, see BlockReader::SelectBlockSize
+  uint32_t blockSize;
+  AccessPattern pattern;
+};
+
+class IoUring;
+
+// Reads many files at once with io_uring, keeping several reads in flight per
+// file. All the reads are submitted and completed on the thread calling Run(),
+// so there are no per-file threads or blocking read() calls.
+//
+// The reader has MAX_OPEN_FILES slots, each reading one file at a time. Blocks
+// of a file are delivered to the slot's callbacks in order.
+class IoUringBatchReader {
+ public:
+  static constexpr uint32_t MAX_OPEN_FILES = 8;
+  static constexpr uint32_t READS_PER_FILE = 4;
+
+  // Block sizes, including the explicit ones, are limited so that the buffers
+  // of all the in-flight reads of a reader take at most 8 MiB.
+  static constexpr uint32_t MAX_BLOCK_SIZE = BlockReader::MEDIUM_BLOCK_SIZE;
+
+  IoUringBatchReader();
+  IoUringBatchReader(const IoUringBatchReader& other) = delete;
+  virtual ~IoUringBatchReader();
+
+  // Returns false if io_uring is not supported by the platform or the kernel,
+  // or is disabled - the caller should fall back to BlockReader then.
+  bool Init();
+
+  // Reads the files while NextFile() returns true.
+  //
+  // Throws PlatformException on the first error.
+  void Run();
+
+ protected:
+  // Requests the next file to read in the slot. Returns false if there are no
+  // more files. request.path should stay valid until OnEnd() of the slot.
+  virtual bool NextFile(uint32_t slot, IoUringFileRequest& request) = 0;
+
+  virtual void OnBlock(uint32_t slot, const uint8_t* data, size_t length) = 0;
+  virtual void OnEnd(uint32_t slot) = 0;
+
+ private:
+  struct FileSlot;
+
+  std::unique_ptr<IoUring> _ring;
+  std::unique_ptr<FileSlot[]> _files;
+  uint32_t _inFlight = 0;
+
+#ifdef HAS_IO_URING
+  bool OpenNext(uint32_t slot);
+  void QueueReads(uint32_t slot);
+  void ConsumeReads(uint32_t slot);
+  void HandleCompletion(uint64_t userData, int32_t result);
+  void Release(FileSlot& file);
+  void Drain();
+#endif
+};
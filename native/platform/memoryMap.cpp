@@ -1,6 +1,9 @@
 #include "memoryMap.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <utility>
 
@@ -13,12 +16,148 @@
 #include <unistd.h>
 #endif
 
+#ifndef _WIN32
+#include <pthread.h>
+#include <signal.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
+
 #include "platformError.h"
 
 #undef min
+#undef max
+
+#ifndef _WIN32
+namespace {
+
+// The guards live in a fixed table rather than in thread_local variables: in a
+// dlopen'ed addon, the first access to a thread_local from a thread may
+// allocate its TLS block, which is not async-signal-safe, and the handler runs
+// on any thread that faults. A thread claims a free slot for the duration of
+// the access; the handler looks up the slot of the current thread.
+struct MemoryAccessGuard {
+  std::atomic<bool> claimed;
+
+  // Set last and cleared first, the other fields are valid while it's set.
+  std::atomic<sigjmp_buf*> jumpBuffer;
+
+  std::atomic<pthread_t> thread;
+  std::atomic<uintptr_t> begin;
+  std::atomic<uintptr_t> end;
+};
+
+constexpr size_t MAX_GUARDED_THREADS = 256;
+
+MemoryAccessGuard guards[MAX_GUARDED_THREADS];
+
+// The slot claimed by the current thread. Only used outside of the handler.
+thread_local MemoryAccessGuard* currentGuard = nullptr;
+
+std::once_flag handlerInstalledFlag;
+struct sigaction previousAction;
+
+void ChainToPreviousHandler(int signal, siginfo_t* info, void* context) {
+  if (previousAction.sa_flags & SA_SIGINFO) {
+    previousAction.sa_sigaction(signal, info, context);
+  } else if (previousAction.sa_handler == SIG_DFL ||
+             previousAction.sa_handler == SIG_IGN) {
+    // Restore the default action: the faulting instruction is executed again
+    // when the handler returns, and the signal kills the process as usual.
+    struct sigaction defaultAction;
+    memset(&defaultAction, 0, sizeof(defaultAction));
+    defaultAction.sa_handler = SIG_DFL;
+
+    sigaction(signal, &defaultAction, nullptr);
+  } else {
+    previousAction.sa_handler(signal);
+  }
+}
+
+void HandleBusError(int signal, siginfo_t* info, void* context) {
+  auto address = (uintptr_t)info->si_addr;
+  pthread_t self = pthread_self();
+
+  for (auto& guard : guards) {
+    sigjmp_buf* jumpBuffer = guard.jumpBuffer.load(std::memory_order_acquire);
+
+    if (jumpBuffer != nullptr &&
+        pthread_equal(guard.thread.load(std::memory_order_relaxed), self) &&
+        address >= guard.begin.load(std::memory_order_relaxed) &&
+        address < guard.end.load(std::memory_order_relaxed)) {
+      // The slot is released by _ClearMemoryAccessGuard after the jump.
+      guard.jumpBuffer.store(nullptr, std::memory_order_relaxed);
+
+      siglongjmp(*jumpBuffer, 1);
+    }
+  }
+
+  ChainToPreviousHandler(signal, info, context);
+}
+
+void InstallBusErrorHandler() {
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_sigaction = HandleBusError;
+  action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+  sigemptyset(&action.sa_mask);
+
+  sigaction(SIGBUS, &action, &previousAction);
+}
+
+MemoryAccessGuard* ClaimGuard() {
+  while (true) {
+    for (auto& guard : guards) {
+      bool claimed = false;
+
+      if (guard.claimed.compare_exchange_strong(claimed, true,
+                                                std::memory_order_acquire)) {
+        return &guard;
+      }
+    }
+
+    // All the slots are taken by other threads, which release them as soon as
+    // they're done with their windows.
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+void _SetMemoryAccessGuard(sigjmp_buf* jumpBuffer, const uint8_t* address,
+                           size_t length) {
+  std::call_once(handlerInstalledFlag, InstallBusErrorHandler);
+
+  // The fault can be reported at the beginning of the page.
+  uintptr_t pageMask = (uintptr_t)sysconf(_SC_PAGESIZE) - 1;
+
+  MemoryAccessGuard* guard = ClaimGuard();
+  guard->thread.store(pthread_self(), std::memory_order_relaxed);
+  guard->begin.store((uintptr_t)address & ~pageMask, std::memory_order_relaxed);
+  guard->end.store((uintptr_t)address + length, std::memory_order_relaxed);
+  guard->jumpBuffer.store(jumpBuffer, std::memory_order_release);
+
+  currentGuard = guard;
+
+  // The guard should be set before the memory is accessed.
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+void _ClearMemoryAccessGuard() {
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+
+  if (currentGuard != nullptr) {
+    currentGuard->jumpBuffer.store(nullptr, std::memory_order_relaxed);
+    currentGuard->claimed.store(false, std::memory_order_release);
+    currentGuard = nullptr;
+  }
+}
+#endif
 
 bool MemoryMappedFile::Open(const NativeString& path, size_t offset,
-                            size_t length) {
+                            size_t length, AccessPattern pattern) {
   auto handle = FileHandle::OpenRead(path);
   CHECK_PLATFORM_ERROR(handle.IsInvalid())
 
@@ -27,20 +166,6 @@ bool MemoryMappedFile::Open(const NativeString& path, size_t offset,
   CHECK_PLATFORM_ERROR(!GetFileSizeEx(handle, &largeFileSize))
 
   size_t fileSize = (size_t)largeFileSize.QuadPart;
-  _size = std::min(length, fileSize);
-
-  if (_size == 0) {
-    return true;
-  }
-
-  _fileMapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
-  CHECK_PLATFORM_ERROR(_fileMapping == NULL)
-
-  void* mapAddress = MapViewOfFile(_fileMapping, FILE_MAP_READ, 0, 0, 0);
-
-  CHECK_PLATFORM_ERROR(mapAddress == NULL)
-
-  _fileHandle = std::move(handle);
 #else
   struct stat statInfo;
   CHECK_PLATFORM_ERROR(fstat(handle, &statInfo) < 0)
@@ -51,7 +176,9 @@ bool MemoryMappedFile::Open(const NativeString& path, size_t offset,
   }
 
   size_t fileSize = (size_t)statInfo.st_size;
-  _size = std::min(length, fileSize);
+#endif
+
+  _size = offset < fileSize ? std::min(length, fileSize - offset) : 0;
 
   if (_size == 0) {
     // mmap can fail if fileSize == 0.
@@ -60,32 +187,140 @@ bool MemoryMappedFile::Open(const NativeString& path, size_t offset,
     return true;
   }
 
-  void* mapAddress = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, handle, 0);
+#ifdef _WIN32
+  _fileMapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+  CHECK_PLATFORM_ERROR(_fileMapping == NULL)
+#endif
+
+  _offset = offset;
+  _pattern = pattern;
+  _fileHandle = std::move(handle);
+
+  return true;
+}
+
+static size_t GetMapAlignment() {
+#ifdef _WIN32
+  // Views should start at a multiple of the allocation granularity.
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+
+  return info.dwAllocationGranularity;
+#else
+  return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+size_t MemoryMappedFile::GetWindowSize() {
+  static const size_t windowSize = [] {
+    const char* value = std::getenv("XXHASH_BINDINGS_MAP_WINDOW_SIZE");
+
+    if (value == nullptr) {
+      return WINDOW_SIZE;
+    }
+
+    // Invalid and zero values are ignored.
+    size_t size = (size_t)std::strtoull(value, nullptr, 10);
+
+    return size != 0 ? size : WINDOW_SIZE;
+  }();
+
+  return windowSize;
+}
+
+const uint8_t* MemoryMappedFile::MapWindow(size_t position, size_t& length) {
+  UnmapWindow();
+
+  length = std::min(GetWindowSize(), _size - position);
+
+  if (length == 0) {
+    return nullptr;
+  }
+
+  static const size_t alignment = GetMapAlignment();
+
+  size_t windowOffset = _offset + position;
+  size_t mapOffset = windowOffset & ~(alignment - 1);
+  size_t mapSize = length + (windowOffset - mapOffset);
+
+#ifdef _WIN32
+  void* mapAddress = MapViewOfFile(_fileMapping, FILE_MAP_READ,
+                                   (DWORD)((uint64_t)mapOffset >> 32),
+                                   (DWORD)mapOffset, mapSize);
+
+  CHECK_PLATFORM_ERROR(mapAddress == NULL)
+#else
+  int flags = MAP_PRIVATE;
+
+#ifdef MAP_POPULATE
+  if (_pattern == AccessPattern::Populate) {
+    flags |= MAP_POPULATE;
+  }
+#endif
+
+  void* mapAddress =
+      mmap(NULL, mapSize, PROT_READ, flags, _fileHandle, (off_t)mapOffset);
 
   CHECK_PLATFORM_ERROR(mapAddress == MAP_FAILED)
 #endif
-  _address = (const uint8_t*)mapAddress;
-  _address += offset;
+  _mapAddress = mapAddress;
+  _mapSize = mapSize;
+  _windowOffset = windowOffset;
+  _windowLength = length;
 
-  if (offset + _size > fileSize) {
-    _size = (offset >= fileSize) ? 0 : (fileSize - offset);
-  }
+  auto address = (const uint8_t*)mapAddress + (windowOffset - mapOffset);
+  Advise(address, length);
 
-  return true;
+  return address;
 }
 
-MemoryMappedFile::~MemoryMappedFile() {
+void MemoryMappedFile::UnmapWindow() {
+  if (_mapAddress == nullptr) {
+    return;
+  }
+
 #ifdef _WIN32
-  if (_address != nullptr) {
-    UnmapViewOfFile(_address);
+  UnmapViewOfFile(_mapAddress);
+#else
+  munmap(_mapAddress, _mapSize);
+#endif
+
+  _mapAddress = nullptr;
+
+  AdviseFileDone(_fileHandle, _windowOffset, _windowLength, _pattern);
+}
+
+void MemoryMappedFile::Advise(const uint8_t* address, size_t length) {
+#ifndef _WIN32
+  if (_pattern == AccessPattern::Normal) {
+    return;
   }
 
+  // madvise requires a page-aligned address.
+  uintptr_t pageMask = (uintptr_t)sysconf(_SC_PAGESIZE) - 1;
+  uintptr_t begin = (uintptr_t)address & ~pageMask;
+  size_t adviceLength = (uintptr_t)address + length - begin;
+
+  madvise((void*)begin, adviceLength, MADV_SEQUENTIAL);
+  madvise((void*)begin, adviceLength, MADV_WILLNEED);
+
+#ifdef MADV_HUGEPAGE
+  // Backs the mapping with huge pages where the file system supports it
+  // (tmpfs, or read-only THP for regular files), which reduces the number of
+  // page faults and TLB misses.
+  if (adviceLength >= HUGE_PAGE_SIZE) {
+    madvise((void*)begin, adviceLength, MADV_HUGEPAGE);
+  }
+#endif
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  UnmapWindow();
+
+#ifdef _WIN32
   if (_fileMapping != INVALID_HANDLE_VALUE) {
     CloseHandle(_fileMapping);
   }
-#else
-  if (_address != nullptr) {
-    munmap((void*)_address, _size);
-  }
 #endif
-}
\ No newline at end of file
+}
@@ -3,47 +3,134 @@
 #include <uv.h>
 #include <v8.h>
 
+#include <cerrno>
 #include <cstdint>
 
-#include "handle.h"
-
 #ifdef _WIN32
 #include <windows.h>
+#else
+#include <setjmp.h>
+#endif
+
+#include "accessPattern.h"
+#include "handle.h"
+#include "platformError.h"
+
+#ifndef _WIN32
+// Makes SIGBUS raised by an access to [address, address + length) on the
+// current thread jump to jumpBuffer instead of killing the process. That's how
+// an I/O error or truncation of a mapped file is reported on POSIX.
+void _SetMemoryAccessGuard(sigjmp_buf* jumpBuffer, const uint8_t* address,
+                           size_t length);
+void _ClearMemoryAccessGuard();
 #endif
 
 class MemoryMappedFile {
  public:
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+  static constexpr size_t WINDOW_SIZE = 256 * 1024 * 1024;
+
+  // The size of the window ranges are mapped by. It's WINDOW_SIZE unless the
+  // XXHASH_BINDINGS_MAP_WINDOW_SIZE environment variable overrides it, which
+  // lets the tests cover window boundaries with small files.
+  static size_t GetWindowSize();
+
+  // Error code to report when the mapped memory can't be read.
+#ifdef _WIN32
+  static constexpr ErrorDesc ACCESS_ERROR = ERROR_READ_FAULT;
+#else
+  static constexpr ErrorDesc ACCESS_ERROR = EIO;
+#endif
+
   MemoryMappedFile() {}
   MemoryMappedFile(const MemoryMappedFile& other) = delete;
   ~MemoryMappedFile();
 
-  bool Open(const NativeString& path, size_t offset, size_t length);
+  // Returns false if the file can't be mapped (it's not a regular file).
+  bool Open(const NativeString& path, size_t offset, size_t length,
+            AccessPattern pattern = AccessPattern::Sequential);
 
+  // Calls acc(address, length) for each window of the range in order, at
+  // least once (with zero length if the range is empty). If an I/O error
+  // occurs while the memory is accessed, handler() is called instead.
   template <typename Accessor, typename Handler>
   void Access(Accessor acc, Handler handler) {
+    size_t position = 0;
+
+    do {
+      size_t length;
+      const uint8_t* address = MapWindow(position, length);
+
+      if (!AccessWindow(acc, handler, address, length)) {
+        return;
+      }
+
+      position += length;
+    } while (position < _size);
+  }
+
+  inline size_t GetSize() { return _size; }
+
+ private:
+  size_t _size = 0;
+  size_t _offset = 0;
+
+  // The current window, the address passed to the accessor points inside it.
+  void* _mapAddress = nullptr;
+  size_t _mapSize = 0;
+  size_t _windowOffset = 0;
+  size_t _windowLength = 0;
+
+  AccessPattern _pattern = AccessPattern::Normal;
+  FileHandle _fileHandle;
+
+#ifdef _WIN32
+  HANDLE _fileMapping = INVALID_HANDLE_VALUE;
+#endif
+
+  // Maps the window of the range that starts at position, unmapping the
+  // previous one. length receives the length of the window.
+  const uint8_t* MapWindow(size_t position, size_t& length);
+  void UnmapWindow();
+  void Advise(const uint8_t* address, size_t length);
+
+  // Returns false if the handler was called.
+  template <typename Accessor, typename Handler>
+  static bool AccessWindow(Accessor& acc, Handler& handler,
+                           const uint8_t* address, size_t length) {
 #ifdef _WIN32
     __try {
-      acc(_address);
+      acc(address, length);
     } __except (GetExceptionCode() == EXCEPTION_IN_PAGE_ERROR ||
                         GetExceptionCode() == EXCEPTION_ACCESS_VIOLATION
                     ? EXCEPTION_EXECUTE_HANDLER
                     : EXCEPTION_CONTINUE_SEARCH) {
       handler();
+      return false;
     }
 #else
-    // TODO: Add error handling
-    acc(_address);
-#endif
-  }
+    // The accessor should not own objects with non-trivial destructors, as
+    // they're skipped by siglongjmp.
+    sigjmp_buf jumpBuffer;
 
-  inline size_t GetSize() { return _size; }
+    if (sigsetjmp(jumpBuffer, 1) != 0) {
+      _ClearMemoryAccessGuard();
+      handler();
+      return false;
+    }
 
- private:
-  const uint8_t* _address = nullptr;
-  size_t _size = 0;
+    _SetMemoryAccessGuard(&jumpBuffer, address, length);
 
-#ifdef _WIN32
-  FileHandle _fileHandle;
-  HANDLE _fileMapping = INVALID_HANDLE_VALUE;
+    try {
+      acc(address, length);
+    } catch (...) {
+      _ClearMemoryAccessGuard();
+      throw;
+    }
+
+    _ClearMemoryAccessGuard();
 #endif
+
+    return true;
+  }
 };
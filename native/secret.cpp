@@ -0,0 +1,29 @@
+#define XXH_STATIC_LINKING_ONLY
+
+#include "index.h"
+#include "jsObjectParser.h"
+#include "xxhash.h"
+
+Napi::Value XxHashAddon::GenerateSecret(const Napi::CallbackInfo& info) {
+  auto env = info.Env();
+
+  if (info.Length() != 1) {
+    throw Napi::Error::New(env, "Wrong number of arguments");
+  }
+
+  auto secret = Napi::Uint8Array::New(env, XXH3_SECRET_DEFAULT_SIZE);
+  JsTypedArrayInfo seedArray;
+
+  // Either arbitrary bytes, which are spread over the secret, or a 64-bit seed.
+  if (JsGetTypedArrayInfo(env, info[0], seedArray) &&
+      seedArray.type == napi_uint8_array) {
+    XXH3_generateSecret(secret.Data(), XXH3_SECRET_DEFAULT_SIZE,
+                        seedArray.data, seedArray.length);
+  } else {
+    uint64_t seed = JsParseArgument<uint64_t>(env, info[0], "seed");
+
+    XXH3_generateSecret_fromSeed(secret.Data(), seed);
+  }
+
+  return secret;
+}
@@ -0,0 +1,112 @@
+#include "stateSerialization.h"
+
+#include <cstring>
+
+static const uint8_t STATE_MAGIC[4] = {'X', 'X', 'H', 'S'};
+
+enum SerializedStateFlags : uint8_t {
+  STATE_HAS_SECRET = 1 << 0,
+};
+
+// Fields are stored in the native byte order, like the state itself.
+struct SerializedStateHeader {
+  uint8_t magic[4];
+  uint8_t version;
+  uint8_t variant;
+  uint8_t flags;
+  uint8_t reserved;
+  uint32_t xxhashVersion;
+  uint32_t stateSize;
+  uint64_t seed;
+  uint64_t secretSize;
+};
+
+size_t GetSerializedStateSize(const XxHashDynamicState& state,
+                              const HashKey& key) {
+  return sizeof(SerializedStateHeader) + state.GetStateSize() +
+         (key.secret != nullptr ? key.secretSize : 0);
+}
+
+void SerializeState(uint32_t variant, const XxHashDynamicState& state,
+                    const HashKey& key, uint8_t* destination) {
+  SerializedStateHeader header{};
+  memcpy(header.magic, STATE_MAGIC, sizeof(STATE_MAGIC));
+  header.version = SERIALIZED_STATE_VERSION;
+  header.variant = (uint8_t)variant;
+  header.xxhashVersion = XXH_VERSION_NUMBER;
+  header.stateSize = (uint32_t)state.GetStateSize();
+  header.seed = key.seed;
+
+  if (key.secret != nullptr) {
+    header.flags |= STATE_HAS_SECRET;
+    header.secretSize = key.secretSize;
+  }
+
+  memcpy(destination, &header, sizeof(header));
+  destination += sizeof(header);
+
+  state.Save(destination);
+  destination += header.stateSize;
+
+  if (key.secret != nullptr) {
+    memcpy(destination, key.secret, key.secretSize);
+  }
+}
+
+StateDeserializationStatus DeserializeState(uint32_t variant,
+                                            const uint8_t* data, size_t length,
+                                            XxHashDynamicState& state,
+                                            HashKey& key) {
+  SerializedStateHeader header;
+
+  if (length < sizeof(header)) {
+    return StateDeserializationStatus::InvalidData;
+  }
+
+  memcpy(&header, data, sizeof(header));
+
+  if (memcmp(header.magic, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0) {
+    return StateDeserializationStatus::InvalidData;
+  }
+
+  if (header.version != SERIALIZED_STATE_VERSION ||
+      header.xxhashVersion != XXH_VERSION_NUMBER) {
+    return StateDeserializationStatus::IncompatibleVersion;
+  }
+
+  if (header.variant != variant) {
+    return StateDeserializationStatus::VariantMismatch;
+  }
+
+  state = XxHashDynamicState(variant);
+
+  if (header.stateSize != state.GetStateSize()) {
+    return StateDeserializationStatus::IncompatibleVersion;
+  }
+
+  bool hasSecret = (header.flags & STATE_HAS_SECRET) != 0;
+  size_t payloadLength = length - sizeof(header);
+
+  if ((hasSecret && !IsSecretSupported(variant)) ||
+      payloadLength < header.stateSize ||
+      payloadLength - header.stateSize != (hasSecret ? header.secretSize : 0)) {
+    return StateDeserializationStatus::InvalidData;
+  }
+
+  const uint8_t* nativeState = data + sizeof(header);
+
+  if (hasSecret) {
+    if (header.secretSize < XXH3_SECRET_SIZE_MIN) {
+      return StateDeserializationStatus::InvalidData;
+    }
+
+    key = HashKey::WithSecret(nativeState + header.stateSize,
+                              (size_t)header.secretSize)
+              .Own();
+  } else {
+    key = HashKey(header.seed);
+  }
+
+  return state.Load(nativeState, key) ? StateDeserializationStatus::Ok
+                                      : StateDeserializationStatus::InvalidData;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include "hashers.h"
+
+// Version of the serialized state format. The native state is copied as is,
+// so the header also records the version of xxhash and the size of the state:
+// a state can only be restored by a build with the same layout of it.
+constexpr uint8_t SERIALIZED_STATE_VERSION = 1;
+
+enum class StateDeserializationStatus {
+  Ok,
+  InvalidData,
+  IncompatibleVersion,
+  VariantMismatch,
+};
+
+// Serialized state: the header, the native state and the secret (if the key
+// has one).
+size_t GetSerializedStateSize(const XxHashDynamicState& state,
+                              const HashKey& key);
+
+void SerializeState(uint32_t variant, const XxHashDynamicState& state,
+                    const HashKey& key, uint8_t* destination);
+
+// Restores the state of the given variant. The key owns the secret.
+StateDeserializationStatus DeserializeState(uint32_t variant,
+                                            const uint8_t* data, size_t length,
+                                            XxHashDynamicState& state,
+                                            HashKey& key);
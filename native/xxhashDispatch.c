@@ -0,0 +1,366 @@
+// Runtime selection of the XXH3 vector kernels.
+//
+// The addon is built for the baseline of the target architecture (SSE2 on
+// x86-64), so the kernels for the wider instruction sets are compiled here with
+// per-function target attributes and picked once, based on CPUID.
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(_M_AMD64)
+#define XXH_DISPATCH_X86 1
+#endif
+
+#ifdef XXH_DISPATCH_X86
+#if defined(__GNUC__) || defined(__clang__)
+#define XXH_TARGET_SSE2 __attribute__((__target__("sse2")))
+#define XXH_TARGET_AVX2 __attribute__((__target__("avx2")))
+#define XXH_TARGET_AVX512 __attribute__((__target__("avx512f")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+// MSVC allows any intrinsic without additional compiler flags.
+#define XXH_TARGET_SSE2
+#define XXH_TARGET_AVX2
+#define XXH_TARGET_AVX512
+#include <intrin.h>
+#else
+#error "Unsupported compiler"
+#endif
+
+#define XXH_X86DISPATCH
+#define XXH_DISPATCH_AVX2 1
+#define XXH_DISPATCH_AVX512 1
+#endif
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+#include "xxhashDispatch.h"
+
+#ifdef XXH_DISPATCH_X86
+
+typedef XXH64_hash_t (*XxHashLong64)(const void* XXH_RESTRICT input,
+                                     size_t length, XXH64_hash_t seed);
+typedef XXH128_hash_t (*XxHashLong128)(const void* XXH_RESTRICT input,
+                                       size_t length, XXH64_hash_t seed);
+typedef XXH64_hash_t (*XxHashLong64Secret)(const void* XXH_RESTRICT input,
+                                           size_t length,
+                                           const void* XXH_RESTRICT secret,
+                                           size_t secretLength);
+typedef XXH128_hash_t (*XxHashLong128Secret)(const void* XXH_RESTRICT input,
+                                             size_t length,
+                                             const void* XXH_RESTRICT secret,
+                                             size_t secretLength);
+typedef XXH_errorcode (*XxHashUpdate)(XXH3_state_t* state, const void* input,
+                                      size_t length);
+
+typedef struct {
+  const char* name;
+
+  XxHashLong64 hashLong64;
+  XxHashLong128 hashLong128;
+  XxHashLong64Secret hashLong64Secret;
+  XxHashLong128Secret hashLong128Secret;
+  XxHashUpdate update;
+} XxHashKernels;
+
+#define XXH_DEFINE_KERNELS(suffix, target)                                     \
+  XXH_NO_INLINE target XXH64_hash_t XXH3_hashLong_64b_##suffix(                \
+      const void* XXH_RESTRICT input, size_t length, XXH64_hash_t seed) {      \
+    return XXH3_hashLong_64b_withSeed_internal(                                \
+        input, length, seed, XXH3_accumulate_##suffix,                         \
+        XXH3_scrambleAcc_##suffix, XXH3_initCustomSecret_##suffix);            \
+  }                                                                            \
+                                                                               \
+  XXH_NO_INLINE target XXH128_hash_t XXH3_hashLong_128b_##suffix(              \
+      const void* XXH_RESTRICT input, size_t length, XXH64_hash_t seed) {      \
+    return XXH3_hashLong_128b_withSeed_internal(                               \
+        input, length, seed, XXH3_accumulate_##suffix,                         \
+        XXH3_scrambleAcc_##suffix, XXH3_initCustomSecret_##suffix);            \
+  }                                                                            \
+                                                                               \
+  XXH_NO_INLINE target XXH64_hash_t XXH3_hashLong_64b_secret_##suffix(         \
+      const void* XXH_RESTRICT input, size_t length,                           \
+      const void* XXH_RESTRICT secret, size_t secretLength) {                  \
+    return XXH3_hashLong_64b_internal(input, length, secret, secretLength,     \
+                                      XXH3_accumulate_##suffix,                \
+                                      XXH3_scrambleAcc_##suffix);              \
+  }                                                                            \
+                                                                               \
+  XXH_NO_INLINE target XXH128_hash_t XXH3_hashLong_128b_secret_##suffix(       \
+      const void* XXH_RESTRICT input, size_t length,                           \
+      const void* XXH_RESTRICT secret, size_t secretLength) {                  \
+    return XXH3_hashLong_128b_internal(input, length, secret, secretLength,    \
+                                       XXH3_accumulate_##suffix,               \
+                                       XXH3_scrambleAcc_##suffix);             \
+  }                                                                            \
+                                                                               \
+  XXH_NO_INLINE target XXH_errorcode XXH3_update_##suffix(                     \
+      XXH3_state_t* state, const void* input, size_t length) {                 \
+    return XXH3_update(state, (const xxh_u8*)input, length,                    \
+                       XXH3_accumulate_##suffix, XXH3_scrambleAcc_##suffix);   \
+  }
+
+XXH_DEFINE_KERNELS(sse2, XXH_TARGET_SSE2)
+XXH_DEFINE_KERNELS(avx2, XXH_TARGET_AVX2)
+XXH_DEFINE_KERNELS(avx512, XXH_TARGET_AVX512)
+
+#undef XXH_DEFINE_KERNELS
+
+static const XxHashKernels XXH_kKernelsSse2 = {
+    "sse2",
+    XXH3_hashLong_64b_sse2,
+    XXH3_hashLong_128b_sse2,
+    XXH3_hashLong_64b_secret_sse2,
+    XXH3_hashLong_128b_secret_sse2,
+    XXH3_update_sse2};
+static const XxHashKernels XXH_kKernelsAvx2 = {
+    "avx2",
+    XXH3_hashLong_64b_avx2,
+    XXH3_hashLong_128b_avx2,
+    XXH3_hashLong_64b_secret_avx2,
+    XXH3_hashLong_128b_secret_avx2,
+    XXH3_update_avx2};
+static const XxHashKernels XXH_kKernelsAvx512 = {
+    "avx512",
+    XXH3_hashLong_64b_avx512,
+    XXH3_hashLong_128b_avx512,
+    XXH3_hashLong_64b_secret_avx512,
+    XXH3_hashLong_128b_secret_avx512,
+    XXH3_update_avx512};
+
+static void XXH_cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuidex(info, (int)leaf, (int)subleaf);
+
+  regs[0] = (unsigned)info[0];
+  regs[1] = (unsigned)info[1];
+  regs[2] = (unsigned)info[2];
+  regs[3] = (unsigned)info[3];
+#else
+  __asm__ __volatile__("cpuid"
+                       : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]),
+                         "=d"(regs[3])
+                       : "a"(leaf), "c"(subleaf));
+#endif
+}
+
+static unsigned long long XXH_xgetbv(void) {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+  return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static unsigned XXH_detectCpuFeatures(void) {
+  // Register state that has to be enabled by the OS (XCR0):
+  // SSE + AVX for AVX2 and, additionally, opmask + ZMM for AVX-512.
+  const unsigned long long AVX_STATE = 0x06;
+  const unsigned long long AVX512_STATE = 0xE6;
+
+  unsigned regs[4];
+  unsigned features = 0;
+
+  XXH_cpuid(0, 0, regs);
+  unsigned maxLeaf = regs[0];
+
+  if (maxLeaf < 1) {
+    return 0;
+  }
+
+  XXH_cpuid(1, 0, regs);
+
+  int hasSse2 = (regs[3] >> 26) & 1;
+  int hasOsXsave = (regs[2] >> 27) & 1;
+  int hasAvx = (regs[2] >> 28) & 1;
+
+  if (hasSse2) {
+    features |= XXH_CPU_SSE2;
+  }
+
+  if (!hasOsXsave || !hasAvx || maxLeaf < 7) {
+    return features;
+  }
+
+  unsigned long long xcr0 = XXH_xgetbv();
+  XXH_cpuid(7, 0, regs);
+
+  int hasAvx2 = (regs[1] >> 5) & 1;
+  int hasAvx512 = (regs[1] >> 16) & 1;
+
+  if (hasAvx2 && (xcr0 & AVX_STATE) == AVX_STATE) {
+    features |= XXH_CPU_AVX2;
+
+    if (hasAvx512 && (xcr0 & AVX512_STATE) == AVX512_STATE) {
+      features |= XXH_CPU_AVX512;
+    }
+  }
+
+  return features;
+}
+
+// Initialization is idempotent, so concurrent first calls only lead to the
+// same values being written more than once.
+static unsigned XXH_g_cpuFeatures = 0;
+static const XxHashKernels* XXH_g_kernels = NULL;
+
+static const XxHashKernels* XXH_getKernels(void) {
+  const XxHashKernels* kernels = XXH_g_kernels;
+
+  if (kernels == NULL) {
+    unsigned features = XXH_detectCpuFeatures();
+
+    if (features & XXH_CPU_AVX512) {
+      kernels = &XXH_kKernelsAvx512;
+    } else if (features & XXH_CPU_AVX2) {
+      kernels = &XXH_kKernelsAvx2;
+    } else {
+      kernels = &XXH_kKernelsSse2;
+    }
+
+    XXH_g_cpuFeatures = features;
+    XXH_g_kernels = kernels;
+  }
+
+  return kernels;
+}
+
+static XXH64_hash_t XXH3_hashLong_64b_dispatch(const void* XXH_RESTRICT input,
+                                               size_t length,
+                                               XXH64_hash_t seed,
+                                               const xxh_u8* XXH_RESTRICT secret,
+                                               size_t secretLength) {
+  (void)secret;
+  (void)secretLength;
+
+  return XXH_getKernels()->hashLong64(input, length, seed);
+}
+
+static XXH128_hash_t XXH3_hashLong_128b_dispatch(
+    const void* XXH_RESTRICT input, size_t length, XXH64_hash_t seed,
+    const void* XXH_RESTRICT secret, size_t secretLength) {
+  (void)secret;
+  (void)secretLength;
+
+  return XXH_getKernels()->hashLong128(input, length, seed);
+}
+
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(const void* input, size_t length,
+                                           XXH64_hash_t seed) {
+  return XXH3_64bits_internal(input, length, seed, XXH3_kSecret,
+                              sizeof(XXH3_kSecret), XXH3_hashLong_64b_dispatch);
+}
+
+XXH128_hash_t XXH3_128bits_withSeed_dispatch(const void* input, size_t length,
+                                             XXH64_hash_t seed) {
+  return XXH3_128bits_internal(input, length, seed, XXH3_kSecret,
+                               sizeof(XXH3_kSecret),
+                               XXH3_hashLong_128b_dispatch);
+}
+
+static XXH64_hash_t XXH3_hashLong_64b_secret_dispatch(
+    const void* XXH_RESTRICT input, size_t length, XXH64_hash_t seed,
+    const xxh_u8* XXH_RESTRICT secret, size_t secretLength) {
+  (void)seed;
+
+  return XXH_getKernels()->hashLong64Secret(input, length, secret,
+                                            secretLength);
+}
+
+static XXH128_hash_t XXH3_hashLong_128b_secret_dispatch(
+    const void* XXH_RESTRICT input, size_t length, XXH64_hash_t seed,
+    const void* XXH_RESTRICT secret, size_t secretLength) {
+  (void)seed;
+
+  return XXH_getKernels()->hashLong128Secret(input, length, secret,
+                                             secretLength);
+}
+
+XXH64_hash_t XXH3_64bits_withSecret_dispatch(const void* input, size_t length,
+                                             const void* secret,
+                                             size_t secretLength) {
+  return XXH3_64bits_internal(input, length, 0, secret, secretLength,
+                              XXH3_hashLong_64b_secret_dispatch);
+}
+
+XXH128_hash_t XXH3_128bits_withSecret_dispatch(const void* input,
+                                               size_t length,
+                                               const void* secret,
+                                               size_t secretLength) {
+  return XXH3_128bits_internal(input, length, 0, secret, secretLength,
+                               XXH3_hashLong_128b_secret_dispatch);
+}
+
+XXH_errorcode XXH3_64bits_update_dispatch(XXH3_state_t* state,
+                                          const void* input, size_t length) {
+  return XXH_getKernels()->update(state, input, length);
+}
+
+XXH_errorcode XXH3_128bits_update_dispatch(XXH3_state_t* state,
+                                           const void* input, size_t length) {
+  return XXH_getKernels()->update(state, input, length);
+}
+
+unsigned XXH_cpuFeatures(void) {
+  XXH_getKernels();
+
+  return XXH_g_cpuFeatures;
+}
+
+const char* XXH_activeVectorPath(void) { return XXH_getKernels()->name; }
+
+#else
+
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(const void* input, size_t length,
+                                           XXH64_hash_t seed) {
+  return XXH3_64bits_withSeed(input, length, seed);
+}
+
+XXH128_hash_t XXH3_128bits_withSeed_dispatch(const void* input, size_t length,
+                                             XXH64_hash_t seed) {
+  return XXH3_128bits_withSeed(input, length, seed);
+}
+
+XXH64_hash_t XXH3_64bits_withSecret_dispatch(const void* input, size_t length,
+                                             const void* secret,
+                                             size_t secretLength) {
+  return XXH3_64bits_withSecret(input, length, secret, secretLength);
+}
+
+XXH128_hash_t XXH3_128bits_withSecret_dispatch(const void* input,
+                                               size_t length,
+                                               const void* secret,
+                                               size_t secretLength) {
+  return XXH3_128bits_withSecret(input, length, secret, secretLength);
+}
+
+XXH_errorcode XXH3_64bits_update_dispatch(XXH3_state_t* state,
+                                          const void* input, size_t length) {
+  return XXH3_64bits_update(state, input, length);
+}
+
+XXH_errorcode XXH3_128bits_update_dispatch(XXH3_state_t* state,
+                                           const void* input, size_t length) {
+  return XXH3_128bits_update(state, input, length);
+}
+
+unsigned XXH_cpuFeatures(void) { return 0; }
+
+const char* XXH_activeVectorPath(void) {
+#if XXH_VECTOR == XXH_NEON
+  return "neon";
+#elif XXH_VECTOR == XXH_SVE
+  return "sve";
+#elif XXH_VECTOR == XXH_VSX
+  return "vsx";
+#elif XXH_VECTOR == XXH_LSX
+  return "lsx";
+#elif XXH_VECTOR == XXH_LASX
+  return "lasx";
+#else
+  return "scalar";
+#endif
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "xxhash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bit flags of the vector instruction sets supported by both the CPU and the OS.
+enum XxHashCpuFeature {
+  XXH_CPU_SSE2 = 1 << 0,
+  XXH_CPU_AVX2 = 1 << 1,
+  XXH_CPU_AVX512 = 1 << 2,
+};
+
+// XXH3 entry points which select the widest available vector kernel on the
+// first call. On non-x86 platforms they forward to the regular functions.
+XXH64_hash_t XXH3_64bits_withSeed_dispatch(const void* input, size_t length,
+                                           XXH64_hash_t seed);
+XXH128_hash_t XXH3_128bits_withSeed_dispatch(const void* input, size_t length,
+                                             XXH64_hash_t seed);
+
+// secretLength should be at least XXH3_SECRET_SIZE_MIN.
+XXH64_hash_t XXH3_64bits_withSecret_dispatch(const void* input, size_t length,
+                                             const void* secret,
+                                             size_t secretLength);
+XXH128_hash_t XXH3_128bits_withSecret_dispatch(const void* input,
+                                               size_t length,
+                                               const void* secret,
+                                               size_t secretLength);
+
+XXH_errorcode XXH3_64bits_update_dispatch(XXH3_state_t* state,
+                                          const void* input, size_t length);
+XXH_errorcode XXH3_128bits_update_dispatch(XXH3_state_t* state,
+                                           const void* input, size_t length);
+
+// Returns a combination of XxHashCpuFeature flags.
+unsigned XXH_cpuFeatures(void);
+
+// Returns the name of the kernel used by the dispatched functions:
+// "scalar", "sse2", "avx2", "avx512" or the compile-time default on non-x86
+// platforms ("neon", "vsx", ...).
+const char* XXH_activeVectorPath(void);
+
+#ifdef __cplusplus
+}
+#endif
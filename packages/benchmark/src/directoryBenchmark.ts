@@ -81,6 +81,16 @@ export async function run(): Promise<Bench> {
       .add(`block async (${name})`, () => {
         return xxhash3.directoryToMapAsync(blockOptions);
       });
+
+    const fileOptions = fs
+      .readdirSync(path)
+      .map((fileName) => ({ path: `${path}/${fileName}`, seed: 1 }));
+
+    for (const ioUring of [false, true]) {
+      bench.add(`filesAsync io_uring ${ioUring} (${name})`, () => {
+        return xxhash3.filesAsync(fileOptions, { ioUring });
+      });
+    }
   }
 
   return bench;
@@ -10,6 +10,16 @@ const fileInfos: { name: string; size: number }[] = [
   { name: 'kb1', size: KB },
 ];
 
+// undefined - adaptive block size.
+const blockSizes: (number | undefined)[] = [
+  undefined,
+  4 * KB,
+  64 * KB,
+  256 * KB,
+  MB,
+  4 * MB,
+];
+
 export const name = 'file';
 
 export async function run(): Promise<Bench> {
@@ -41,19 +51,38 @@ export async function run(): Promise<Bench> {
       preferMap: true,
     };
 
-    const blockOptions: FileHashOptions<number> = {
-      path,
-      seed: 1,
-      preferMap: false,
-    };
+    bench.add(`map (${name})`, () => {
+      xxhash3.file(mapOptions);
+    });
 
-    bench
-      .add(`map (${name})`, () => {
-        xxhash3.file(mapOptions);
-      })
-      .add(`block (${name})`, () => {
+    for (const blockSize of blockSizes) {
+      const blockOptions: FileHashOptions<number> = {
+        path,
+        seed: 1,
+        preferMap: false,
+        blockSize,
+      };
+
+      const blockSizeName =
+        blockSize === undefined ? 'adaptive' : `${blockSize / KB} KB`;
+
+      bench.add(`block ${blockSizeName} (${name})`, () => {
         xxhash3.file(blockOptions);
       });
+    }
+
+    for (const readAhead of [false, true]) {
+      const readAheadOptions: FileHashOptions<number> = {
+        path,
+        seed: 1,
+        preferMap: false,
+        readAhead,
+      };
+
+      bench.add(`block read-ahead ${readAhead} (${name})`, () => {
+        xxhash3.file(readAheadOptions);
+      });
+    }
   }
 
   return bench;
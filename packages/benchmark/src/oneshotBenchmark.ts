@@ -0,0 +1,38 @@
+import { Bench } from 'tinybench';
+import { xxhash3 } from 'xxhash-bindings';
+
+// Small keys, where the cost of the call dominates the hashing itself.
+const keySizes = [8, 32, 256];
+
+export const name = 'oneshot';
+
+export async function run(): Promise<Bench> {
+  const bench = new Bench({
+    warmupIterations: 1000,
+    iterations: 100_000,
+  });
+
+  const out = new BigUint64Array(1);
+
+  for (const size of keySizes) {
+    const key = Uint8Array.from({ length: size }, (_, i) => i);
+
+    bench.add(`oneshot (${size} B)`, () => {
+      xxhash3.oneshot(key);
+    });
+
+    bench.add(`oneshotInto (${size} B)`, () => {
+      xxhash3.oneshotInto(key, undefined, out);
+    });
+
+    const state = xxhash3.createState();
+
+    bench.add(`state update (${size} B)`, () => {
+      state.update(key);
+    });
+  }
+
+  return bench;
+}
+
+export default { name, run };
@@ -5,15 +5,23 @@
     "sources": [ 
       "../../native/index.cpp",
       "../../native/fileHash.cpp",
+      "../../native/directoryHash.cpp",
       "../../native/oneshotHash.cpp",
       "../../native/createHashState.cpp",
+      "../../native/cpuFeatures.cpp",
+      "../../native/secret.cpp",
 
       "../../native/xxhash.c",
+      "../../native/xxhashDispatch.c",
       "../../native/jsHashState.cpp",
       "../../native/jsObjectParser.cpp",
       "../../native/fileHashWorker.cpp",
+      "../../native/chunkHasher.cpp",
+      "../../native/stateSerialization.cpp",
      
       "../../native/platform/blockReader.cpp",
+      "../../native/platform/directory.cpp",
+      "../../native/platform/ioUring.cpp",
       "../../native/platform/memoryMap.cpp",
       "../../native/platform/platformError.cpp",
     ],
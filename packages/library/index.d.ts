@@ -1,28 +1,259 @@
+import { Transform } from 'stream';
+import { TransformStream } from 'stream/web';
+
 type UInt64 = number | bigint;
 
 export type XxVariantName = 'xxhash32' | 'xxhash64' | 'xxhash3' | 'xxhash3_128';
 
+// Hints to the OS about how the file is going to be read:
+// - 'normal' - no hints
+// - 'sequential' - the file is read from the beginning to the end, the OS should read ahead aggressively (default)
+// - 'populate' - like 'sequential', and the whole range is loaded into memory at once
+// - 'noreuse' - like 'sequential', and the hashed pages are dropped from the page cache, so that
+//   hashing large files doesn't evict other cached data
+export type AccessPattern = 'normal' | 'sequential' | 'populate' | 'noreuse';
+
 export type FileHashOptions<S> = {
   path: string;
   seed?: S;
+
+  // Custom secret of xxhash3 and xxhash3_128 (at least 136 bytes), see generateSecret.
+  // Can't be combined with seed.
+  secret?: Uint8Array;
   offset?: UInt64;
   length?: UInt64;
   preferMap?: boolean;
+
+  // Size of the blocks the file is read with when it's not mapped. By default, it's selected
+  // based on the size of the file: up to 256 KiB for smaller files and 1 MiB for larger ones.
+  // At most 64 MiB; batches read with io_uring use blocks of at most 256 KiB.
+  blockSize?: number;
+
+  // Whether to read the next block on a background thread while the current one is being hashed.
+  // By default, it's enabled for ranges of at least 16 MiB.
+  readAhead?: boolean;
+
+  accessPattern?: AccessPattern;
+};
+
+// Options of the chunked-tree digest. readAhead is ignored: the chunks are read in parallel.
+export type FileTreeHashOptions<S> = FileHashOptions<S> & {
+  // Size of the chunks hashed independently, 16 MiB by default. It's a part of the digest:
+  // the same file hashed with different chunk sizes gives different results.
+  chunkSize?: UInt64;
+
+  // Number of threads hashing the chunks. Defaults to the number of hardware threads.
+  concurrency?: number;
 };
 
-export type XxHashState<R extends UInt64> = {
+// - 'fixed' - chunks of chunkSize bytes, the last one may be shorter
+// - 'cdc' - content-defined chunks (Gear rolling hash, FastCDC normalized chunking): inserting or
+//   removing data only changes the chunks around the edit. chunkSize is the average size.
+export type ChunkingMode = 'fixed' | 'cdc';
+
+export type ChunkingOptions<S> = {
+  seed?: S;
+  secret?: Uint8Array;
+  chunkSize: number;
+
+  // Defaults to 'fixed'.
+  chunking?: ChunkingMode;
+
+  // Bounds of the chunk size in the 'cdc' mode, a quarter and 8 times of chunkSize by default.
+  minChunkSize?: number;
+  maxChunkSize?: number;
+};
+
+export type FileChunksOptions<S> = FileHashOptions<S> & ChunkingOptions<S>;
+
+// Offsets (in the file or the buffer) and lengths of the chunks and their hashes, see
+// HashResultArray.
+export type Chunks<A extends HashResultArray> = {
+  offsets: Float64Array;
+  lengths: Float64Array;
+  hashes: A;
+};
+
+export type DirectoryHashOptions<S> = {
+  path: string;
+  seed?: S;
+
+  // Custom secret of xxhash3 and xxhash3_128 (at least 136 bytes), see generateSecret.
+  // Can't be combined with seed.
+  secret?: Uint8Array;
+  preferMap?: boolean;
+  blockSize?: number;
+  accessPattern?: AccessPattern;
+
+  // Whether to hash files in subdirectories. Defaults to true.
+  recursive?: boolean;
+
+  // Whether to hash targets of symbolic links instead of skipping them. Defaults to false.
+  // A file reachable through several links is hashed under each path; links to a directory
+  // that contains them are skipped.
+  followSymlinks?: boolean;
+
+  // Number of threads hashing the files. Defaults to the number of hardware threads.
+  concurrency?: number;
+};
+
+export type FileBatchOptions = {
+  // Number of threads hashing the files. Defaults to the number of hardware threads.
+  concurrency?: number;
+
+  // Whether to read the files with io_uring on Linux, keeping several reads in flight per thread.
+  // Defaults to true. Ignored if io_uring is not supported by the kernel.
+  ioUring?: boolean;
+};
+
+export type CpuFeatures = {
+  sse2: boolean;
+  avx2: boolean;
+  avx512: boolean;
+};
+
+// Array of hash results: Uint32Array for xxhash32, BigUint64Array for xxhash64 and xxhash3.
+// For xxhash3_128, each result takes two elements of BigUint64Array: low and high 64 bits.
+export type HashResultArray = Uint32Array | BigUint64Array;
+
+// Receives a single hash result in the native byte order at the given offset (in elements of the
+// array, 0 by default). Writing the result into an array doesn't allocate a number or bigint.
+export type HashResultDestination<A extends HashResultArray> = A | Uint8Array;
+
+export type XxHashState<
+  R extends UInt64,
+  A extends HashResultArray = HashResultArray,
+> = {
   update(data: Uint8Array): void;
   reset(): void;
 
+  // The state isn't finalized: it can be updated after the result is taken.
+  result(): R;
+  resultInto(out: HashResultDestination<A>, offset?: number): void;
+
+  // Hashes data on a worker thread. Updates of a state are applied in the order they were called,
+  // the state can't be used otherwise until they complete. data must not be changed until then,
+  // and its ArrayBuffer must not be detached (transferred to another thread, resized or
+  // transferred with ArrayBuffer.prototype.transfer): the memory would be freed while it's read.
+  // Inputs up to 64 KiB are copied and aren't subject to this.
+  updateAsync(data: Uint8Array): Promise<void>;
+
+  // Returns an independent state with the same seed (or secret) and the data hashed so far.
+  clone(): XxHashState<R, A>;
+
+  // Saves the state to resume hashing later, possibly in another process, with
+  // createState.fromSerialized. The result contains the seed and the secret (if any). It can only
+  // be restored by the same version of the library on the same platform.
+  serialize(): Uint8Array;
+
+  // Drops the secret (if any) and makes the state unusable: other methods throw after it.
+  dispose(): void;
+};
+
+export type StatePoolOptions<K> = {
+  // Maximum number of released states kept for reuse. States released beyond it are disposed.
+  size: number;
+  seed?: K;
+};
+
+// Recycles states instead of creating a new one for each hash. All states of the pool have the
+// seed of the pool.
+export type StatePool<R extends UInt64, A extends HashResultArray> = {
+  // Returns a reset state, a new one if there are no released states.
+  acquire(): XxHashState<R, A>;
+
+  // Resets the state and returns it to the pool. The state must not be used after it.
+  release(state: XxHashState<R, A>): void;
+};
+
+export type CreateState<K, R extends UInt64, A extends HashResultArray> = {
+  (seed?: K): XxHashState<R, A>;
+
+  // Restores a state of the variant from the result of serialize().
+  fromSerialized(data: Uint8Array): XxHashState<R, A>;
+};
+
+// Streams that pass the data through and hash it. Small chunks are coalesced before they're
+// hashed. result() returns the hash of the data written so far, e.g. after the stream is finished.
+export type HashStream<R extends UInt64> = Transform & {
   result(): R;
 };
 
-export type XxHashVariant<S, H extends UInt64> = {
-  oneshot(data: Uint8Array, seed?: S): H;
-  createState(seed?: S): XxHashState<H>;
+export type HashWebStream<R extends UInt64> = TransformStream<
+  Uint8Array,
+  Uint8Array
+> & {
+  result(): R;
+};
+
+// K is the key accepted in place of the seed by oneshot* and createState: xxhash3 and xxhash3_128
+// also accept a custom secret there.
+export type XxHashVariant<
+  S,
+  H extends UInt64,
+  A extends HashResultArray,
+  K = S,
+> = {
+  oneshot(data: Uint8Array, seed?: K): H;
+
+  // Hashes the UTF-8 encoding of the string, the same as oneshot(Buffer.from(data), seed).
+  oneshotString(data: string, seed?: K): H;
+
+  // Hashes data on a worker thread. data must not be changed until the promise is settled, and
+  // its ArrayBuffer must not be detached until then, see updateAsync.
+  oneshotAsync(data: Uint8Array, seed?: K): Promise<H>;
+  oneshotInto(
+    data: Uint8Array,
+    seed: K | undefined,
+    out: HashResultDestination<A>,
+    offset?: number,
+  ): void;
+
+  // Hashes each buffer with the same seed. Results are written to out (or to a new array if
+  // it's not specified), which is returned.
+  oneshotBatch(buffers: Uint8Array[], seed?: K, out?: A): A;
+
+  // Hashes data.subarray(offsets[i], offsets[i + 1]) for each i < offsets.length - 1.
+  oneshotBatch(data: Uint8Array, offsets: Uint32Array, seed?: K, out?: A): A;
+
+  // Hashes the UTF-8 encoding of each string, like oneshotString. Results are written to out (or
+  // to a new array if it's not specified), which is returned.
+  hashStrings(strings: string[], seed?: K, out?: A): A;
+
+  // Splits data into chunks and hashes each of them.
+  oneshotChunks(data: Uint8Array, options: ChunkingOptions<S>): Chunks<A>;
+  createState: CreateState<K, H, A>;
+  createStatePool(options: StatePoolOptions<K>): StatePool<H, A>;
+  hashStream(seed?: K): HashStream<H>;
+  hashWebStream(seed?: K): HashWebStream<H>;
 
   file(options: FileHashOptions<S>): H;
+  fileInto(
+    options: FileHashOptions<S>,
+    out: HashResultDestination<A>,
+    offset?: number,
+  ): void;
   fileAsync(options: FileHashOptions<S>): Promise<H>;
+
+  // Chunked-tree digest of the file, computed on several threads. It's not the same as the
+  // result of file(): it's the hash of the concatenated big-endian hashes of the chunks followed
+  // by the chunk size and the length of the range as big-endian 64-bit integers.
+  fileTree(options: FileTreeHashOptions<S>): H;
+  fileTreeAsync(options: FileTreeHashOptions<S>): Promise<H>;
+  // Hashes each chunk of the file in a single pass over it.
+  fileChunks(options: FileChunksOptions<S>): Chunks<A>;
+  fileChunksAsync(options: FileChunksOptions<S>): Promise<Chunks<A>>;
+
+  filesAsync(
+    options: FileHashOptions<S>[],
+    batchOptions?: FileBatchOptions,
+  ): Promise<H[]>;
+
+  // Keys are paths relative to the directory.
+  directoryToMap(options: DirectoryHashOptions<S>): Map<string, H>;
+  directoryToMapAsync(
+    options: DirectoryHashOptions<S>,
+  ): Promise<Map<string, H>>;
 };
 
 /*
@@ -59,15 +290,40 @@ export class XxHashState3_128 {
 }
   */
 
-export declare const xxhash32: XxHashVariant<number, number>;
-export declare const xxhash64: XxHashVariant<UInt64, bigint>;
-export declare const xxhash3: XxHashVariant<UInt64, bigint>;
-export declare const xxhash3_128: XxHashVariant<UInt64, bigint>;
+export declare const xxhash32: XxHashVariant<number, number, Uint32Array>;
+export declare const xxhash64: XxHashVariant<UInt64, bigint, BigUint64Array>;
+export declare const xxhash3: XxHashVariant<
+  UInt64,
+  bigint,
+  BigUint64Array,
+  UInt64 | Uint8Array
+>;
+export declare const xxhash3_128: XxHashVariant<
+  UInt64,
+  bigint,
+  BigUint64Array,
+  UInt64 | Uint8Array
+>;
+
+// Generates a 192-byte secret for xxhash3 and xxhash3_128 from a 64-bit seed or from arbitrary
+// bytes of any length. The bytes don't have to be random, the result is well distributed anyway.
+export declare function generateSecret(seed: UInt64 | Uint8Array): Uint8Array;
+
+// Vector instruction sets detected at runtime. All flags are false on non-x86 platforms.
+export declare function getCpuFeatures(): CpuFeatures;
+
+// Name of the kernel used by xxhash3 and xxhash3_128: 'sse2', 'avx2', 'avx512' on x86-64,
+// or the compile-time default on other platforms ('neon', 'scalar', ...).
+export declare function activeVectorPath(): string;
+
 declare const _default: {
-  xxhash32: XxHashVariant<number, number>;
-  xxhash64: XxHashVariant<UInt64, bigint>;
-  xxhash3: XxHashVariant<UInt64, bigint>;
-  xxhash3_128: XxHashVariant<UInt64, bigint>;
+  xxhash32: XxHashVariant<number, number, Uint32Array>;
+  xxhash64: XxHashVariant<UInt64, bigint, BigUint64Array>;
+  xxhash3: typeof xxhash3;
+  xxhash3_128: typeof xxhash3_128;
+  generateSecret: typeof generateSecret;
+  getCpuFeatures: typeof getCpuFeatures;
+  activeVectorPath: typeof activeVectorPath;
 };
 
 export default _default;
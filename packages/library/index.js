@@ -1,12 +1,13 @@
 import { createRequire } from 'module';
+import { Transform } from 'stream';
 
 const require = createRequire(import.meta.url);
 const addon = require(`./xxhash-${process.platform}-${process.arch}.node`);
 
 function toPromise(func) {
-  return (options) => {
+  return (...args) => {
     return new Promise((resolve, reject) => {
-      func(options, (error, value) => {
+      func(...args, (error, value) => {
         if (error === undefined) {
           resolve(value);
         } else {
@@ -17,12 +18,174 @@ function toPromise(func) {
   };
 }
 
+function toMap([paths, hashes]) {
+  const result = new Map();
+
+  for (let i = 0; i < paths.length; i++) {
+    result.set(paths[i], hashes[i]);
+  }
+
+  return result;
+}
+
+// Chunks smaller than this are copied into a buffer and hashed together, so
+// that small writes (e.g. TCP-sized chunks) don't cost a native call each.
+const STREAM_BUFFER_SIZE = 16 * 1024;
+
+class StreamHasher {
+  constructor(state) {
+    this._state = state;
+    this._buffer = new Uint8Array(STREAM_BUFFER_SIZE);
+    this._buffered = 0;
+  }
+
+  update(chunk) {
+    // Checked here rather than by the native update: a small chunk is copied
+    // with set(), which would silently coerce e.g. a string to zeros.
+    if (!ArrayBuffer.isView(chunk) || chunk.BYTES_PER_ELEMENT !== 1) {
+      throw new Error('Expected type of the parameter "chunk" is Uint8Array');
+    }
+
+    if (this._buffered + chunk.length > STREAM_BUFFER_SIZE) {
+      this._flush();
+    }
+
+    // The chunk is copied rather than kept: the writer may reuse it.
+    if (chunk.length >= STREAM_BUFFER_SIZE) {
+      this._state.update(chunk);
+    } else {
+      this._buffer.set(chunk, this._buffered);
+      this._buffered += chunk.length;
+    }
+  }
+
+  result() {
+    this._flush();
+
+    return this._state.result();
+  }
+
+  _flush() {
+    if (this._buffered > 0) {
+      this._state.update(this._buffer.subarray(0, this._buffered));
+      this._buffered = 0;
+    }
+  }
+}
+
+function createHashStream(hasher) {
+  const stream = new Transform({
+    transform(chunk, encoding, callback) {
+      try {
+        hasher.update(chunk);
+      } catch (error) {
+        callback(error);
+        return;
+      }
+
+      callback(null, chunk);
+    },
+  });
+
+  stream.result = () => hasher.result();
+
+  return stream;
+}
+
+function createHashWebStream(hasher) {
+  const stream = new TransformStream({
+    transform(chunk, controller) {
+      hasher.update(chunk);
+      controller.enqueue(chunk);
+    },
+  });
+
+  stream.result = () => hasher.result();
+
+  return stream;
+}
+
+// Keeps up to size released states to hand them out again instead of creating
+// new ones. All the states of a pool have the same seed.
+class StatePool {
+  constructor(createState, { size, seed }) {
+    if (!Number.isInteger(size) || size < 0) {
+      throw new Error(
+        '"size" property is expected to be a non-negative integer',
+      );
+    }
+
+    this._createState = createState;
+    this._seed = seed;
+    this._size = size;
+    this._free = new Set();
+    this._owned = new WeakSet();
+  }
+
+  acquire() {
+    for (const state of this._free) {
+      this._free.delete(state);
+
+      return state;
+    }
+
+    const state = this._createState(this._seed);
+    this._owned.add(state);
+
+    return state;
+  }
+
+  release(state) {
+    if (!this._owned.has(state) || this._free.has(state)) {
+      throw new Error('The state is not acquired from the pool');
+    }
+
+    if (this._free.size < this._size) {
+      state.reset();
+      this._free.add(state);
+    } else {
+      this._owned.delete(state);
+      state.dispose();
+    }
+  }
+}
+
 function xxHashVariant(name) {
+  const oneshotAsync = toPromise(addon[`${name}_oneshotAsync`]);
+  const fileAsync = toPromise(addon[`${name}_fileAsync`]);
+  const fileTreeAsync = toPromise(addon[`${name}_fileTreeAsync`]);
+  const fileChunksAsync = toPromise(addon[`${name}_fileChunksAsync`]);
+  const filesAsync = toPromise(addon[`${name}_filesAsync`]);
+  const directoryToMap = addon[`${name}_directoryToMap`];
+  const directoryToMapAsync = toPromise(addon[`${name}_directoryToMapAsync`]);
+  const createState = Object.assign(addon[`${name}_createState`], {
+    fromSerialized: addon[`${name}_createStateFromSerialized`],
+  });
+
   return {
     oneshot: addon[`${name}_oneshot`],
-    createState: addon[`${name}_createState`],
+    oneshotString: addon[`${name}_oneshotString`],
+    oneshotAsync: (data, seed) => oneshotAsync(data, seed),
+    oneshotInto: addon[`${name}_oneshotInto`],
+    oneshotBatch: addon[`${name}_oneshotBatch`],
+    oneshotChunks: addon[`${name}_oneshotChunks`],
+    hashStrings: addon[`${name}_hashStrings`],
+    createState,
+    createStatePool: (options) => new StatePool(createState, options),
+    hashStream: (seed) => createHashStream(new StreamHasher(createState(seed))),
+    hashWebStream: (seed) =>
+      createHashWebStream(new StreamHasher(createState(seed))),
     file: addon[`${name}_file`],
-    fileAsync: toPromise(addon[`${name}_fileAsync`]),
+    fileInto: addon[`${name}_fileInto`],
+    fileAsync: (options) => fileAsync(options),
+    fileTree: addon[`${name}_fileTree`],
+    fileTreeAsync: (options) => fileTreeAsync(options),
+    fileChunks: addon[`${name}_fileChunks`],
+    fileChunksAsync: (options) => fileChunksAsync(options),
+    filesAsync: (options, batchOptions) => filesAsync(options, batchOptions),
+    directoryToMap: (options) => toMap(directoryToMap(options)),
+    directoryToMapAsync: (options) =>
+      directoryToMapAsync(options).then(toMap),
   };
 }
 
@@ -31,4 +194,16 @@ export const xxhash64 = xxHashVariant('xxhash64');
 export const xxhash3 = xxHashVariant('xxhash3');
 export const xxhash3_128 = xxHashVariant('xxhash3_128');
 
-export default { xxhash32, xxhash64, xxhash3, xxhash3_128 };
+export const generateSecret = addon.generateSecret;
+export const getCpuFeatures = addon.getCpuFeatures;
+export const activeVectorPath = addon.activeVectorPath;
+
+export default {
+  xxhash32,
+  xxhash64,
+  xxhash3,
+  xxhash3_128,
+  generateSecret,
+  getCpuFeatures,
+  activeVectorPath,
+};
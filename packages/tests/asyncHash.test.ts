@@ -0,0 +1,118 @@
+import { expect, test } from 'vitest';
+import lib, { generateSecret } from 'xxhash-bindings';
+import { variantNames } from './utils';
+
+const data = Uint8Array.from([...Array(100000).keys()].map((i) => i % 251));
+
+test.each(variantNames.map((name) => [name]))('oneshotAsync', async (name) => {
+  const { oneshot, oneshotAsync } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    await expect(oneshotAsync(data, seed)).resolves.toBe(oneshot(data, seed));
+    await expect(oneshotAsync(Uint8Array.of(), seed)).resolves.toBe(
+      oneshot(Uint8Array.of(), seed),
+    );
+  }
+});
+
+test.each([['xxhash3'], ['xxhash3_128']] as const)(
+  'oneshotAsync with secret',
+  async (name) => {
+    const { oneshot, oneshotAsync } = lib[name];
+    const secret = generateSecret(1);
+
+    const promise = oneshotAsync(data, secret);
+    const expected = oneshot(data, secret);
+    secret.fill(0);
+
+    await expect(promise).resolves.toBe(expected);
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'updateAsync keeps the order',
+  async (name) => {
+    const { createState, oneshot } = lib[name];
+    const state = createState(1);
+
+    const parts = [0, 10, 5000, 5001, 60000, data.length];
+    const updates = [];
+
+    for (let i = 0; i < parts.length - 1; i++) {
+      updates.push(state.updateAsync(data.subarray(parts[i], parts[i + 1])));
+    }
+
+    await Promise.all(updates);
+
+    expect(state.result()).toBe(oneshot(data, 1));
+
+    state.update(data);
+    await state.updateAsync(data);
+
+    const expected = createState(1);
+    expected.update(data);
+    expected.update(data);
+    expected.update(data);
+
+    expect(state.result()).toBe(expected.result());
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'state is locked during updateAsync',
+  async (name) => {
+    const { createState } = lib[name];
+    const state = createState();
+    const update = state.updateAsync(data);
+
+    const error = Error(
+      "The state can't be used until updateAsync() calls complete",
+    );
+
+    expect(() => state.result()).toThrowError(error);
+    expect(() => state.update(data)).toThrowError(error);
+    expect(() => state.reset()).toThrowError(error);
+    expect(() => state.clone()).toThrowError(error);
+
+    await update;
+
+    expect(() => state.result()).not.toThrow();
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'small inputs can be transferred',
+  async (name) => {
+    const { createState, oneshot, oneshotAsync } = lib[name];
+    const expected = oneshot(data.subarray(0, 1000), 1);
+
+    const input = data.slice(0, 1000);
+    const promise = oneshotAsync(input, 1);
+    structuredClone(input.buffer, { transfer: [input.buffer] });
+
+    await expect(promise).resolves.toBe(expected);
+
+    const state = createState(1);
+    const part = data.slice(0, 1000);
+    const update = state.updateAsync(part);
+    structuredClone(part.buffer, { transfer: [part.buffer] });
+
+    await update;
+    expect(state.result()).toBe(expected);
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'async functions throw on invalid data',
+  async (name) => {
+    const { createState, oneshotAsync } = lib[name];
+    const error = Error('Expected type of the parameter "data" is Uint8Array');
+
+    await expect(oneshotAsync(1 as unknown as Uint8Array)).rejects.toThrow(
+      error,
+    );
+    expect(() =>
+      createState().updateAsync(1 as unknown as Uint8Array),
+    ).toThrowError(error);
+  },
+);
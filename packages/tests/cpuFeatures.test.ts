@@ -0,0 +1,28 @@
+import { expect, test } from 'vitest';
+import { activeVectorPath, getCpuFeatures } from 'xxhash-bindings';
+
+test('cpu features', () => {
+  const features = getCpuFeatures();
+
+  expect(typeof features.sse2).toBe('boolean');
+  expect(typeof features.avx2).toBe('boolean');
+  expect(typeof features.avx512).toBe('boolean');
+
+  if (features.avx512) {
+    expect(features.avx2).toBe(true);
+  }
+});
+
+test('active vector path matches cpu features', () => {
+  const { avx2, avx512 } = getCpuFeatures();
+  const path = activeVectorPath();
+
+  if (avx512) {
+    expect(path).toBe('avx512');
+  } else if (avx2) {
+    expect(path).toBe('avx2');
+  } else {
+    expect(path).not.toBe('avx2');
+    expect(path).not.toBe('avx512');
+  }
+});
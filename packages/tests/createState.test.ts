@@ -225,3 +225,68 @@ test.each(variantNames.map((name) => [name]))(
     );
   },
 );
+
+test.each(variantNames.map((name) => [name]))('clone', (name) => {
+  const { createState, oneshot } = lib[name];
+  const prefix = Uint8Array.from([...Array(1000).keys()].map((i) => i % 256));
+
+  for (const seed of [undefined, 1]) {
+    const state = createState(seed);
+    state.update(prefix);
+
+    const clone = state.clone();
+    clone.update(testData1);
+    state.update(testData2);
+
+    expect(clone.result()).toBe(
+      oneshot(Uint8Array.of(...prefix, ...testData1), seed),
+    );
+    expect(state.result()).toBe(
+      oneshot(Uint8Array.of(...prefix, ...testData2), seed),
+    );
+
+    clone.reset();
+    expect(clone.result()).toBe(oneshot(Uint8Array.of(), seed));
+  }
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'result does not finalize',
+  (name) => {
+    const { createState } = lib[name];
+    const state = createState(1);
+
+    state.update(testData1);
+    state.result();
+    state.update(testData2);
+
+    const expected = createState(1);
+    expected.update(Uint8Array.of(...testData1, ...testData2));
+
+    expect(state.result()).toBe(expected.result());
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'each variant has its own state class',
+  (name) => {
+    const { createState } = lib[name];
+    const state = createState(1);
+
+    const otherName = name === 'xxhash32' ? 'xxhash64' : 'xxhash32';
+    expect(state.constructor).not.toBe(
+      lib[otherName].createState().constructor,
+    );
+
+    // The class creates states of its variant from a seed.
+    const StateClass = state.constructor as new (
+      seed?: number,
+    ) => XxHashState<number | bigint>;
+
+    const constructed = new StateClass(1);
+    constructed.update(testData1);
+    state.update(testData1);
+
+    expect(constructed.result()).toBe(state.result());
+  },
+);
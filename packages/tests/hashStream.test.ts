@@ -0,0 +1,103 @@
+import { Readable, Writable } from 'stream';
+import { pipeline } from 'stream/promises';
+import { ReadableStream, TransformStream, WritableStream } from 'stream/web';
+import { expect, test } from 'vitest';
+import lib from 'xxhash-bindings';
+import { variantNames } from './utils';
+
+// Mostly small chunks with a few larger than the coalescing buffer.
+const chunks = [...Array(500).keys()].map((i) =>
+  new Uint8Array(i % 100 === 0 ? 40000 : (i % 7) * 10).fill(i % 256),
+);
+
+const data = Uint8Array.from(chunks.flatMap((chunk) => [...chunk]));
+
+test.each(variantNames.map((name) => [name]))('hashStream', async (name) => {
+  const { hashStream, oneshot } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    const stream = hashStream(seed);
+    const output: Uint8Array[] = [];
+
+    await pipeline(
+      Readable.from(chunks),
+      stream,
+      new Writable({
+        write(chunk, _, callback) {
+          output.push(chunk);
+          callback();
+        },
+      }),
+    );
+
+    expect(stream.result()).toBe(oneshot(data, seed));
+    expect(Buffer.concat(output)).toEqual(Buffer.from(data));
+  }
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'hashWebStream',
+  async (name) => {
+    const { hashWebStream, oneshot } = lib[name];
+
+    const stream = hashWebStream(1);
+    const output: Uint8Array[] = [];
+
+    const input = new ReadableStream<Uint8Array>({
+      start(controller) {
+        chunks.forEach((chunk) => controller.enqueue(chunk));
+        controller.close();
+      },
+    });
+
+    for await (const chunk of input.pipeThrough(stream)) {
+      output.push(chunk);
+    }
+
+    expect(stream.result()).toBe(oneshot(data, 1));
+    expect(Buffer.concat(output)).toEqual(Buffer.from(data));
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'written chunks can be reused',
+  async (name) => {
+    const { hashStream, oneshot } = lib[name];
+
+    const stream = hashStream();
+    const chunk = new Uint8Array(10).fill(1);
+
+    stream.resume();
+    stream.write(chunk);
+    chunk.fill(2);
+    stream.end();
+
+    await new Promise((resolve) => stream.on('finish', resolve));
+
+    expect(stream.result()).toBe(oneshot(new Uint8Array(10).fill(1)));
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'hashWebStream throws on invalid chunks',
+  async (name) => {
+    const { hashWebStream } = lib[name];
+
+    for (const chunk of ['abc', 'a'.repeat(20000), new ArrayBuffer(10)]) {
+      const input = new ReadableStream<unknown>({
+        start(controller) {
+          controller.enqueue(chunk);
+          controller.close();
+        },
+      });
+
+      const stream = hashWebStream() as unknown as TransformStream;
+
+      await expect(
+        input.pipeThrough(stream).pipeTo(new WritableStream()),
+      ).rejects.toThrowError(
+        Error('Expected type of the parameter "chunk" is Uint8Array'),
+      );
+    }
+  },
+);
@@ -0,0 +1,77 @@
+import { expect, test } from 'vitest';
+import lib from 'xxhash-bindings';
+import { createResultArray, hashResultsToArray, variantNames } from './utils';
+
+const strings = [
+  '',
+  'a',
+  'key:1',
+  'é€😀',
+  'a'.repeat(1021) + '😀',
+  'b'.repeat(5000),
+  'c'.repeat(3000),
+];
+
+test.each(variantNames.map((name) => [name]))('hashStrings', (name) => {
+  const { hashStrings, oneshotString } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    const actual = hashResultsToArray(name, hashStrings(strings, seed));
+
+    expect(actual).toEqual(strings.map((s) => oneshotString(s, seed)));
+  }
+
+  expect(hashStrings([]).length).toBe(0);
+});
+
+test.each(variantNames.map((name) => [name]))('writes to out', (name) => {
+  const { hashStrings, oneshotString } = lib[name];
+
+  const out = createResultArray(name, strings.length);
+  const actual = hashStrings(strings, 1, out as never);
+
+  expect(actual).toBe(out);
+  expect(hashResultsToArray(name, actual).slice(0, strings.length)).toEqual(
+    strings.map((s) => oneshotString(s, 1)),
+  );
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'throws if out is detached while reading the strings',
+  (name) => {
+    const { hashStrings } = lib[name];
+    const out = createResultArray(name, 2);
+
+    const list = ['a', 'b'];
+    Object.defineProperty(list, 1, {
+      get() {
+        structuredClone(out.buffer, { transfer: [out.buffer] });
+
+        return 'b';
+      },
+    });
+
+    expect(() => hashStrings(list, 0, out as never)).toThrowError(
+      Error(
+        '"out" parameter is expected to be large enough to hold all the results',
+      ),
+    );
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'throws on invalid strings',
+  (name) => {
+    const { hashStrings } = lib[name];
+
+    expect(() => hashStrings('abc' as unknown as string[])).toThrowError(
+      Error('Expected type of the parameter "strings" is array'),
+    );
+    expect(() => hashStrings(['a', 1 as unknown as string])).toThrowError(
+      Error('"strings" parameter is expected to be an array of strings'),
+    );
+    expect(() =>
+      hashStrings(['a', 'b'], 0, new Uint32Array(0) as never),
+    ).toThrow(/"out"/);
+  },
+);
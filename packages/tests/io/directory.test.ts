@@ -0,0 +1,159 @@
+import { test, expect } from 'vitest';
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import lib, { DirectoryHashOptions, XxVariantName } from 'xxhash-bindings';
+import { testData, variantNames } from '@/utils';
+
+type DirectoryHasher = (
+  options: DirectoryHashOptions<number>,
+) => Promise<Map<string, number | bigint>>;
+
+const hashers: [string, (name: XxVariantName) => DirectoryHasher][] = [
+  [
+    'sync',
+    (name) => (options) => Promise.resolve(lib[name].directoryToMap(options)),
+  ],
+  ['async', (name) => lib[name].directoryToMapAsync],
+];
+
+function expectedMap(
+  name: XxVariantName,
+  relativePaths: string[],
+  seed?: number,
+): Map<string, number | bigint> {
+  const { file } = lib[name];
+
+  return new Map(
+    relativePaths.map((p) => {
+      const nativePath = path.join(...p.split('/'));
+
+      return [nativePath, file({ path: testData(`dir/${p}`), seed })];
+    }),
+  );
+}
+
+for (const [kind, getHasher] of hashers) {
+  test.each(variantNames.map((name) => [name]))(
+    `${kind} recursive`,
+    async (name) => {
+      const directoryToMap = getHasher(name);
+
+      for (const preferMap of [undefined, false, true]) {
+        for (const seed of [undefined, 1]) {
+          const actual = await directoryToMap({
+            path: testData('dir'),
+            preferMap,
+            seed,
+          });
+
+          expect(actual).toEqual(
+            expectedMap(
+              name,
+              ['file1.txt', 'file2.txt', 'dir2/file3.txt'],
+              seed,
+            ),
+          );
+        }
+      }
+    },
+  );
+
+  test.each(variantNames.map((name) => [name]))(
+    `${kind} non-recursive`,
+    async (name) => {
+      const directoryToMap = getHasher(name);
+
+      const actual = await directoryToMap({
+        path: testData('dir'),
+        recursive: false,
+      });
+
+      expect(actual).toEqual(expectedMap(name, ['file1.txt', 'file2.txt']));
+    },
+  );
+
+  test.each(variantNames.map((name) => [name]))(
+    `${kind} empty directory`,
+    async (name) => {
+      const directoryToMap = getHasher(name);
+
+      const actual = await directoryToMap({ path: testData('empty_dir') });
+
+      expect(actual.size).toBe(0);
+    },
+  );
+
+  test.each(variantNames.map((name) => [name]))(
+    `${kind} throws on non-existent path`,
+    async (name) => {
+      const directoryToMap = getHasher(name);
+
+      await expect(() =>
+        directoryToMap({ path: './.should_not_exist' }),
+      ).rejects.toBeTruthy();
+    },
+  );
+
+  test.each(variantNames.map((name) => [name]))(
+    `${kind} throws on invalid recursive`,
+    async (name) => {
+      const directoryToMap = getHasher(name);
+
+      await expect(() =>
+        directoryToMap({
+          path: testData('dir'),
+          recursive: 1 as unknown as boolean,
+        }),
+      ).rejects.toEqual(
+        Error(
+          'Expected type of the property "recursive" is boolean or undefined',
+        ),
+      );
+    },
+  );
+
+  // Creating symbolic links requires extra privileges on Windows.
+  test.skipIf(process.platform === 'win32').each(
+    variantNames.map((name) => [name]),
+  )(`${kind} followSymlinks`, async (name) => {
+    const directoryToMap = getHasher(name);
+    const { file } = lib[name];
+
+    const root = fs.mkdtempSync(path.join(os.tmpdir(), 'xxhash-'));
+
+    try {
+      fs.mkdirSync(path.join(root, 'a'));
+      fs.mkdirSync(path.join(root, 'b'));
+      fs.copyFileSync(testData('dir/file1.txt'), path.join(root, 'a/f'));
+      fs.copyFileSync(testData('dir/file2.txt'), path.join(root, 'b/g'));
+
+      fs.symlinkSync('a/f', path.join(root, 'file_link'));
+      fs.symlinkSync('../a', path.join(root, 'b/sibling_link'));
+      fs.symlinkSync('.', path.join(root, 'self_link'));
+      fs.symlinkSync('..', path.join(root, 'a/parent_link'));
+
+      const hashOf = (p: string) => file({ path: path.join(root, p) });
+
+      await expect(directoryToMap({ path: root })).resolves.toEqual(
+        new Map([
+          ['a/f', hashOf('a/f')],
+          ['b/g', hashOf('b/g')],
+        ]),
+      );
+
+      await expect(
+        directoryToMap({ path: root, followSymlinks: true }),
+      ).resolves.toEqual(
+        new Map([
+          ['a/f', hashOf('a/f')],
+          ['b/g', hashOf('b/g')],
+          ['b/sibling_link/f', hashOf('a/f')],
+          ['file_link', hashOf('a/f')],
+        ]),
+      );
+    } finally {
+      fs.rmSync(root, { recursive: true });
+    }
+  });
+}
@@ -0,0 +1,106 @@
+import { test, expect } from 'vitest';
+import fs from 'fs';
+import lib from 'xxhash-bindings';
+import { hashResultsToArray, testData, variantNames } from '@/utils';
+
+test.each(variantNames.map((name) => [name]))('fixed chunks', async (name) => {
+  const { oneshot, fileChunks, fileChunksAsync } = lib[name];
+  const path = testData('image1.png');
+  const data = fs.readFileSync(path);
+
+  for (const chunkSize of [1000, 4096, 1024 * 1024]) {
+    const offsets = [...Array(Math.ceil(data.length / chunkSize)).keys()].map(
+      (i) => i * chunkSize,
+    );
+    const lengths = offsets.map((offset) =>
+      Math.min(chunkSize, data.length - offset),
+    );
+    const hashes = offsets.map((offset, i) =>
+      oneshot(data.subarray(offset, offset + lengths[i]), 1),
+    );
+
+    for (const preferMap of [false, true]) {
+      for (const readAhead of [false, true]) {
+        const options = { path, seed: 1, chunkSize, preferMap, readAhead };
+
+        for (const actual of [
+          fileChunks(options),
+          await fileChunksAsync(options),
+        ]) {
+          expect([...actual.offsets]).toEqual(offsets);
+          expect([...actual.lengths]).toEqual(lengths);
+          expect(hashResultsToArray(name, actual.hashes)).toEqual(hashes);
+        }
+      }
+    }
+  }
+});
+
+test.each(variantNames.map((name) => [name]))('range', (name) => {
+  const { oneshot, fileChunks } = lib[name];
+  const path = testData('image1.png');
+  const data = fs.readFileSync(path);
+
+  const actual = fileChunks({
+    path,
+    offset: 100,
+    length: 2500,
+    chunkSize: 1000,
+  });
+
+  expect([...actual.offsets]).toEqual([100, 1100, 2100]);
+  expect([...actual.lengths]).toEqual([1000, 1000, 500]);
+  expect(hashResultsToArray(name, actual.hashes)).toEqual([
+    oneshot(data.subarray(100, 1100)),
+    oneshot(data.subarray(1100, 2100)),
+    oneshot(data.subarray(2100, 2600)),
+  ]);
+
+  const empty = fileChunks({ path: testData('emptyfile'), chunkSize: 1000 });
+
+  expect(empty.offsets.length).toBe(0);
+  expect(empty.hashes.length).toBe(0);
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'content-defined chunks match the buffer',
+  async (name) => {
+    const { oneshotChunks, fileChunks, fileChunksAsync } = lib[name];
+    const path = testData('image1.png');
+    const data = fs.readFileSync(path);
+
+    const chunking = { chunking: 'cdc', chunkSize: 256 } as const;
+    const expected = oneshotChunks(data, { ...chunking, seed: 1 });
+
+    for (const preferMap of [false, true]) {
+      for (const blockSize of [undefined, 100]) {
+        const options = { path, seed: 1, preferMap, blockSize, ...chunking };
+
+        for (const actual of [
+          fileChunks(options),
+          await fileChunksAsync(options),
+        ]) {
+          expect(actual).toEqual(expected);
+        }
+      }
+    }
+  },
+);
+
+test.each(variantNames.map((name) => [name]))('throws', async (name) => {
+  const { fileChunks, fileChunksAsync } = lib[name];
+  const path = testData('image1.png');
+
+  expect(() => fileChunks({ path, chunkSize: 0 })).toThrowError(
+    Error('"chunkSize" property is expected to be a positive integer'),
+  );
+  expect(() =>
+    fileChunks({ path } as unknown as { path: string; chunkSize: number }),
+  ).toThrowError(
+    Error('Expected type of the property "chunkSize" is number'),
+  );
+
+  await expect(() =>
+    fileChunksAsync({ path: testData('non-existent'), chunkSize: 1000 }),
+  ).rejects.toBeTruthy();
+});
@@ -1,11 +1,19 @@
 import { test, expect, describe } from 'vitest';
 import fs from 'fs';
-import { FileHashOptions, XxVariantName } from 'xxhash-bindings';
+import { AccessPattern, FileHashOptions, XxVariantName } from 'xxhash-bindings';
 import { numberWithBigint } from './helpers';
 import { testData, variantNames } from '@/utils';
 
 const preferMapValues = [undefined, false, true];
 
+// Hashes of image1.png with seed 1, which don't depend on how it's read.
+const seededImageHashes: [XxVariantName, number | bigint][] = [
+  ['xxhash32', 1945663033],
+  ['xxhash64', BigInt('17740802669433987345')],
+  ['xxhash3', BigInt('8310716519890529791')],
+  ['xxhash3_128', BigInt('132161492315031615344357334049880780287')],
+];
+
 type GenericFileHasher = (
   options: FileHashOptions<number>,
 ) => Promise<number | bigint>;
@@ -123,12 +131,7 @@ export function setupTests({
       }
     });
 
-    test.each<[XxVariantName, number | bigint]>([
-      ['xxhash32', 1945663033],
-      ['xxhash64', BigInt('17740802669433987345')],
-      ['xxhash3', BigInt('8310716519890529791')],
-      ['xxhash3_128', BigInt('132161492315031615344357334049880780287')],
-    ])('with seed', async (name, expected) => {
+    test.each(seededImageHashes)('with seed', async (name, expected) => {
       const file = getFileFactory(name);
 
       for (const preferMap of preferMapValues) {
@@ -142,6 +145,64 @@ export function setupTests({
       }
     });
 
+    test.each(seededImageHashes)('with block size', async (name, expected) => {
+      const file = getFileFactory(name);
+
+      for (const blockSize of [undefined, 0, 1, 100, 4096, 1024 * 1024]) {
+        const actual = await file({
+          path: testData('image1.png'),
+          seed: 1,
+          blockSize,
+        });
+
+        expect(actual).toBe(expected);
+      }
+    });
+
+    test.each(seededImageHashes)(
+      'with access pattern',
+      async (name, expected) => {
+        const file = getFileFactory(name);
+        const accessPatterns = [
+          undefined,
+          'normal',
+          'sequential',
+          'populate',
+          'noreuse',
+        ] as const;
+
+        for (const accessPattern of accessPatterns) {
+          for (const preferMap of preferMapValues) {
+            const actual = await file({
+              path: testData('image1.png'),
+              seed: 1,
+              preferMap,
+              accessPattern,
+            });
+
+            expect(actual).toBe(expected);
+          }
+        }
+      },
+    );
+
+    test.each(seededImageHashes)('with read-ahead', async (name, expected) => {
+      const file = getFileFactory(name);
+
+      for (const readAhead of [undefined, false, true]) {
+        for (const blockSize of [undefined, 100, 4096]) {
+          const actual = await file({
+            path: testData('image1.png'),
+            seed: 1,
+            blockSize,
+            readAhead,
+          });
+
+          expect(actual).toBe(expected);
+        }
+      }
+    });
+
     test.each<[XxVariantName, number | bigint]>([
       ['xxhash32', 46947589],
       ['xxhash64', BigInt('17241709254077376921')],
@@ -236,6 +297,72 @@ export function setupTests({
       },
     );
 
+    test.each(variantNames.map((name) => [name]))(
+      'throws on invalid blockSize',
+      async (name) => {
+        const file = getFileFactory(name);
+
+        await expectToThrowError(
+          { path: testData('image1.png'), blockSize: -1 },
+          file,
+          Error('"blockSize" property is expected to be non-negative integer'),
+        );
+
+        await expectToThrowError(
+          { path: testData('image1.png'), blockSize: 64 * 1024 * 1024 + 1 },
+          file,
+          Error('"blockSize" property is expected to be at most 64 MiB'),
+        );
+      },
+    );
+
+    test.each(variantNames.map((name) => [name]))(
+      'throws on invalid accessPattern',
+      async (name) => {
+        const file = getFileFactory(name);
+
+        await expectToThrowError(
+          {
+            path: testData('image1.png'),
+            accessPattern: 1 as unknown as AccessPattern,
+          },
+          file,
+          Error(
+            'Expected type of the property "accessPattern" is string or undefined',
+          ),
+        );
+
+        await expectToThrowError(
+          {
+            path: testData('image1.png'),
+            accessPattern: 'random' as AccessPattern,
+          },
+          file,
+          Error(
+            `"accessPattern" property is expected to be one of 'normal', 'sequential', 'populate', 'noreuse'`,
+          ),
+        );
+      },
+    );
+
+    test.each(variantNames.map((name) => [name]))(
+      'throws on invalid readAhead',
+      async (name) => {
+        const file = getFileFactory(name);
+
+        await expectToThrowError(
+          {
+            path: testData('image1.png'),
+            readAhead: 1 as unknown as boolean,
+          },
+          file,
+          Error(
+            'Expected type of the property "readAhead" is boolean or undefined',
+          ),
+        );
+      },
+    );
+
     test.each(variantNames.map((name) => [name]))(
       'throws on non-existent path',
       async (name) => {
@@ -0,0 +1,106 @@
+import { test, expect } from 'vitest';
+import fs from 'fs';
+import lib, { XxVariantName } from 'xxhash-bindings';
+import { testData, variantNames } from '@/utils';
+
+const resultSizes: Record<XxVariantName, number> = {
+  xxhash32: 4,
+  xxhash64: 8,
+  xxhash3: 8,
+  xxhash3_128: 16,
+};
+
+function writeBigEndian(
+  out: Uint8Array,
+  offset: number,
+  size: number,
+  value: number | bigint,
+) {
+  let rest = BigInt(value);
+
+  for (let i = size - 1; i >= 0; i--) {
+    out[offset + i] = Number(rest & BigInt(0xff));
+    rest >>= BigInt(8);
+  }
+}
+
+// Reference implementation of the chunked-tree digest.
+function treeDigest(
+  name: XxVariantName,
+  data: Uint8Array,
+  chunkSize: number,
+  seed?: number,
+) {
+  const { oneshot } = lib[name];
+  const resultSize = resultSizes[name];
+  const chunkCount = Math.ceil(data.length / chunkSize);
+  const digests = new Uint8Array(chunkCount * resultSize + 16);
+
+  for (let i = 0; i < chunkCount; i++) {
+    const chunk = data.subarray(i * chunkSize, (i + 1) * chunkSize);
+
+    writeBigEndian(digests, i * resultSize, resultSize, oneshot(chunk, seed));
+  }
+
+  writeBigEndian(digests, chunkCount * resultSize, 8, chunkSize);
+  writeBigEndian(digests, chunkCount * resultSize + 8, 8, data.length);
+
+  return oneshot(digests, seed);
+}
+
+test.each(variantNames.map((name) => [name]))('tree digest', async (name) => {
+  const { fileTree, fileTreeAsync } = lib[name];
+  const path = testData('image1.png');
+  const data = fs.readFileSync(path);
+
+  for (const chunkSize of [1000, 4096, undefined]) {
+    const expected = treeDigest(name, data, chunkSize ?? 16 * 1024 * 1024, 1);
+
+    for (const preferMap of [false, true]) {
+      for (const concurrency of [undefined, 1, 3]) {
+        const options = { path, seed: 1, chunkSize, preferMap, concurrency };
+
+        expect(fileTree(options)).toBe(expected);
+        expect(await fileTreeAsync(options)).toBe(expected);
+      }
+    }
+  }
+});
+
+test.each(variantNames.map((name) => [name]))('range', (name) => {
+  const { fileTree } = lib[name];
+  const path = testData('image1.png');
+  const data = fs.readFileSync(path);
+
+  expect(fileTree({ path, offset: 100, length: 5000, chunkSize: 1024 })).toBe(
+    treeDigest(name, data.subarray(100, 5100), 1024),
+  );
+  expect(fileTree({ path: testData('emptyfile'), chunkSize: 1024 })).toBe(
+    treeDigest(name, Uint8Array.of(), 1024),
+  );
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'differs from file digest',
+  (name) => {
+    const { file, fileTree } = lib[name];
+    const options = { path: testData('image1.png') };
+
+    expect(fileTree(options)).not.toBe(file(options));
+  },
+);
+
+test.each(variantNames.map((name) => [name]))('throws', async (name) => {
+  const { fileTree, fileTreeAsync } = lib[name];
+
+  expect(() =>
+    fileTree({ path: testData('image1.png'), chunkSize: 0 }),
+  ).toThrowError(
+    Error('"chunkSize" property is expected to be a positive integer'),
+  );
+
+  expect(() => fileTree({ path: testData('non-existent') })).toThrowError();
+  await expect(() =>
+    fileTreeAsync({ path: testData('non-existent') }),
+  ).rejects.toBeTruthy();
+});
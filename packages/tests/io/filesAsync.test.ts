@@ -0,0 +1,121 @@
+import { test, expect } from 'vitest';
+import lib, { XxVariantName } from 'xxhash-bindings';
+import { testData, variantNames } from '@/utils';
+
+test.each<[XxVariantName, (number | bigint)[]]>([
+  ['xxhash32', [52811677, 46947589, 1945663033]],
+  [
+    'xxhash64',
+    [
+      BigInt('18153045472420481988'),
+      BigInt('17241709254077376921'),
+      BigInt('17740802669433987345'),
+    ],
+  ],
+  [
+    'xxhash3',
+    [
+      BigInt('12531405323377630900'),
+      BigInt('3244421341483603138'),
+      BigInt('8310716519890529791'),
+    ],
+  ],
+  [
+    'xxhash3_128',
+    [
+      BigInt('193898327962634967863812790837365759668'),
+      BigInt('204254712233039002205064565430793619839'),
+      BigInt('132161492315031615344357334049880780287'),
+    ],
+  ],
+])('hashes files in order', async (name, expected) => {
+  const { filesAsync } = lib[name];
+
+  for (const preferMap of [undefined, false, true]) {
+    for (const concurrency of [undefined, 1, 2, 16]) {
+      for (const ioUring of [undefined, false, true]) {
+        const actual = await filesAsync(
+          [
+            { path: testData('image1.png'), preferMap },
+            { path: testData('emptyfile'), preferMap },
+            { path: testData('image1.png'), preferMap, seed: 1 },
+          ],
+          { concurrency, ioUring },
+        );
+
+        expect(actual).toEqual(expected);
+      }
+    }
+  }
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'many files',
+  async (name) => {
+    const { file, filesAsync } = lib[name];
+    const options = [...Array(500).keys()].map((index) => ({
+      path: testData(index % 2 === 0 ? 'image1.png' : 'onebyte'),
+      seed: index % 3,
+    }));
+
+    const actual = await filesAsync(options);
+
+    expect(actual).toEqual(options.map((o) => file(o)));
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'many ranges and block sizes',
+  async (name) => {
+    const { file, filesAsync } = lib[name];
+    const options = [...Array(100).keys()].map((index) => ({
+      path: testData('image1.png'),
+      offset: index * 7,
+      length: index % 4 === 0 ? undefined : index * 31,
+      blockSize: [undefined, 1, 100, 4096][index % 4],
+    }));
+
+    for (const ioUring of [false, true]) {
+      const actual = await filesAsync(options, { ioUring });
+
+      expect(actual).toEqual(options.map((o) => file(o)));
+    }
+  },
+);
+
+test.each(variantNames.map((name) => [name]))('empty list', async (name) => {
+  const { filesAsync } = lib[name];
+
+  expect(await filesAsync([])).toEqual([]);
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'rejects on non-existent path',
+  async (name) => {
+    const { filesAsync } = lib[name];
+
+    for (const ioUring of [false, true]) {
+      await expect(() =>
+        filesAsync(
+          [{ path: testData('image1.png') }, { path: './.should_not_exist' }],
+          { ioUring },
+        ),
+      ).rejects.toBeTruthy();
+    }
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'rejects on invalid options',
+  async (name) => {
+    const { filesAsync } = lib[name];
+
+    await expect(() =>
+      filesAsync([{ path: 123 as unknown as string }]),
+    ).rejects.toEqual(Error('Expected type of the property "path" is string'));
+
+    await expect(() => filesAsync(1 as unknown as [])).rejects.toEqual(
+      Error('Expected type of the parameter "options" is array'),
+    );
+  },
+);
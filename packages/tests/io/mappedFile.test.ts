@@ -0,0 +1,94 @@
+import { test, expect } from 'vitest';
+import fs from 'fs';
+import os from 'os';
+import path from 'path';
+import { Worker } from 'worker_threads';
+import lib from 'xxhash-bindings';
+import { variantNames } from '@/utils';
+
+// Set by vitest.config.ts, so that ranges of a few megabytes span several
+// windows of the mapping.
+const windowSize = Number(process.env.XXHASH_BINDINGS_MAP_WINDOW_SIZE);
+
+test.each(variantNames.map((name) => [name]))(
+  'ranges spanning map windows',
+  (name) => {
+    const { file } = lib[name];
+    const size = 3 * windowSize + 12345;
+
+    const root = fs.mkdtempSync(path.join(os.tmpdir(), 'xxhash-'));
+    const filePath = path.join(root, 'file');
+    const data = new Uint8Array(size).map((_, i) => (i * 2654435761) >>> 13);
+    fs.writeFileSync(filePath, data);
+
+    try {
+      // The offsets aren't page-aligned, except the first one.
+      for (const offset of [0, 1, 4097, windowSize - 1, windowSize + 3]) {
+        for (const length of [windowSize, windowSize + 1, 2 * windowSize + 7]) {
+          const options = { path: filePath, offset, length };
+
+          expect(file({ ...options, preferMap: true })).toEqual(
+            file({ ...options, preferMap: false }),
+          );
+        }
+      }
+    } finally {
+      fs.rmSync(root, { recursive: true });
+    }
+  },
+);
+
+// Truncates the file and restores its size in a loop until stop is set.
+const truncatingWorkerCode = `
+const fs = require('fs');
+const { workerData } = require('worker_threads');
+const stop = new Int32Array(workerData.stop);
+
+while (Atomics.load(stop, 0) === 0) {
+  fs.truncateSync(workerData.path, 0);
+  fs.truncateSync(workerData.path, workerData.size);
+}
+`;
+
+// A mapped file can't be truncated on Windows.
+test.skipIf(process.platform === 'win32')(
+  'reports truncation of a mapped file as an error',
+  async () => {
+    const { file } = lib.xxhash3;
+    const size = 16 * 1024 * 1024;
+
+    const root = fs.mkdtempSync(path.join(os.tmpdir(), 'xxhash-'));
+    const filePath = path.join(root, 'file');
+    fs.writeFileSync(filePath, new Uint8Array(size).fill(1));
+
+    const stop = new SharedArrayBuffer(4);
+    const worker = new Worker(truncatingWorkerCode, {
+      eval: true,
+      workerData: { path: filePath, size, stop },
+    });
+
+    try {
+      await new Promise((resolve) => worker.once('online', resolve));
+
+      // The file shrinks while it's hashed sooner or later. Without the SIGBUS
+      // handler that would kill the process.
+      let failures = 0;
+
+      for (let i = 0; i < 1000 && failures === 0; i++) {
+        try {
+          file({ path: filePath, preferMap: true });
+        } catch (error) {
+          expect(error).toEqual(Error('Input/output error'));
+          failures++;
+        }
+      }
+
+      expect(failures).toBe(1);
+    } finally {
+      Atomics.store(new Int32Array(stop), 0, 1);
+      await new Promise((resolve) => worker.once('exit', resolve));
+
+      fs.rmSync(root, { recursive: true });
+    }
+  },
+);
@@ -0,0 +1,133 @@
+import { expect, test } from 'vitest';
+import lib, { XxVariantName } from 'xxhash-bindings';
+import { createResultArray, hashResultsToArray, variantNames } from './utils';
+
+const buffers = [
+  Uint8Array.of(),
+  Uint8Array.of(97),
+  Uint8Array.from([97, 98, 99, 100]),
+  Uint8Array.from([...Array(1000).keys()].map((i) => i % 256)),
+];
+
+test.each(variantNames.map((name) => [name]))('buffer list', (name) => {
+  const { oneshot, oneshotBatch } = lib[name];
+
+  for (const seed of [undefined, 0, 1]) {
+    const actual = hashResultsToArray(name, oneshotBatch(buffers, seed));
+
+    expect(actual).toEqual(buffers.map((buffer) => oneshot(buffer, seed)));
+  }
+});
+
+test.each(variantNames.map((name) => [name]))('data with offsets', (name) => {
+  const { oneshot, oneshotBatch } = lib[name];
+
+  const data = Uint8Array.from([...Array(256).keys()]);
+  const offsets = Uint32Array.from([0, 0, 1, 5, 5, 100, 256]);
+
+  const expected = [...Array(offsets.length - 1).keys()].map((i) =>
+    oneshot(data.subarray(offsets[i], offsets[i + 1]), 1),
+  );
+
+  expect(hashResultsToArray(name, oneshotBatch(data, offsets, 1))).toEqual(
+    expected,
+  );
+});
+
+test.each(variantNames.map((name) => [name]))('writes to out', (name) => {
+  const { oneshot, oneshotBatch } = lib[name];
+
+  const out = createResultArray(name, buffers.length + 1);
+  const actual = oneshotBatch(buffers, undefined, out as never);
+
+  expect(actual).toBe(out);
+  expect(
+    hashResultsToArray(name, actual).slice(0, buffers.length),
+  ).toEqual(buffers.map((buffer) => oneshot(buffer)));
+});
+
+test.each(variantNames.map((name) => [name]))('empty batch', (name) => {
+  const { oneshotBatch } = lib[name];
+
+  expect(oneshotBatch([]).length).toBe(0);
+  expect(oneshotBatch(Uint8Array.of(), Uint32Array.of()).length).toBe(0);
+  expect(oneshotBatch(Uint8Array.of(), Uint32Array.of(0)).length).toBe(0);
+});
+
+test.each<[XxVariantName, string]>([
+  ['xxhash32', 'Uint32Array'],
+  ['xxhash64', 'BigUint64Array'],
+  ['xxhash3', 'BigUint64Array'],
+  ['xxhash3_128', 'BigUint64Array'],
+])('throws on invalid out', (name, expectedType) => {
+  const { oneshotBatch } = lib[name];
+
+  expect(() =>
+    oneshotBatch(buffers, 0, new Float64Array(16) as never),
+  ).toThrowError(
+    Error(
+      `Expected type of the parameter "out" is ${expectedType} or undefined`,
+    ),
+  );
+
+  expect(() =>
+    oneshotBatch(buffers, 0, createResultArray(name, 1) as never),
+  ).toThrowError(
+    Error(
+      '"out" parameter is expected to be large enough to hold all the results',
+    ),
+  );
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'throws if out is detached while reading the buffers',
+  (name) => {
+    const { oneshotBatch } = lib[name];
+    const out = createResultArray(name, buffers.length);
+
+    const list = [...buffers];
+    Object.defineProperty(list, 1, {
+      get() {
+        structuredClone(out.buffer, { transfer: [out.buffer] });
+
+        return buffers[1];
+      },
+    });
+
+    expect(() => oneshotBatch(list, 0, out as never)).toThrowError(
+      Error(
+        '"out" parameter is expected to be large enough to hold all the results',
+      ),
+    );
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'throws on invalid offsets',
+  (name) => {
+    const { oneshotBatch } = lib[name];
+    const data = Uint8Array.of(1, 2, 3);
+    const error = Error(
+      '"offsets" parameter is expected to be non-decreasing and within the data',
+    );
+
+    expect(() => oneshotBatch(data, Uint32Array.of(2, 1))).toThrowError(error);
+    expect(() => oneshotBatch(data, Uint32Array.of(0, 4))).toThrowError(error);
+    expect(() =>
+      oneshotBatch(data, [0, 1] as unknown as Uint32Array),
+    ).toThrowError(
+      Error('Expected type of the parameter "offsets" is Uint32Array'),
+    );
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'throws on invalid buffer',
+  (name) => {
+    const { oneshotBatch } = lib[name];
+
+    expect(() =>
+      oneshotBatch([Uint8Array.of(), 1 as unknown as Uint8Array]),
+    ).toThrowError(Error('Expected type of the parameter "data" is Uint8Array'));
+  },
+);
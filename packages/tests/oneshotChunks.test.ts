@@ -0,0 +1,127 @@
+import { expect, test } from 'vitest';
+import lib from 'xxhash-bindings';
+import { hashResultsToArray, variantNames } from './utils';
+
+// Deterministic pseudo-random data.
+function createData(length: number): Uint8Array {
+  const data = new Uint8Array(length);
+  let state = 1;
+
+  for (let i = 0; i < length; i++) {
+    state = (state * 1103515245 + 12345) >>> 0;
+    data[i] = state >>> 24;
+  }
+
+  return data;
+}
+
+const data = createData(256 * 1024);
+
+test.each(variantNames.map((name) => [name]))('fixed chunks', (name) => {
+  const { oneshot, oneshotChunks } = lib[name];
+
+  const actual = oneshotChunks(data, { chunkSize: 1000, seed: 1 });
+  const count = Math.ceil(data.length / 1000);
+
+  expect(actual.offsets.length).toBe(count);
+  expect(hashResultsToArray(name, actual.hashes)).toEqual(
+    [...Array(count).keys()].map((i) =>
+      oneshot(data.subarray(i * 1000, (i + 1) * 1000), 1),
+    ),
+  );
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'content-defined chunks',
+  (name) => {
+    const { oneshot, oneshotChunks } = lib[name];
+
+    const options = {
+      chunking: 'cdc',
+      chunkSize: 4096,
+      minChunkSize: 1024,
+      maxChunkSize: 16384,
+    } as const;
+
+    const { offsets, lengths, hashes } = oneshotChunks(data, options);
+    const hashArray = hashResultsToArray(name, hashes);
+
+    let offset = 0;
+
+    for (let i = 0; i < offsets.length; i++) {
+      expect(offsets[i]).toBe(offset);
+
+      if (i < offsets.length - 1) {
+        expect(lengths[i]).toBeGreaterThanOrEqual(1024);
+      }
+
+      expect(lengths[i]).toBeLessThanOrEqual(16384);
+      expect(hashArray[i]).toBe(
+        oneshot(data.subarray(offset, offset + lengths[i])),
+      );
+
+      offset += lengths[i];
+    }
+
+    expect(offset).toBe(data.length);
+
+    // Inserting data changes only the chunks around the edit.
+    const edited = new Uint8Array(data.length + 10);
+    edited.set(data.subarray(0, 100_000));
+    edited.set(data.subarray(100_000), 100_010);
+
+    const editedHashes = hashResultsToArray(
+      name,
+      oneshotChunks(edited, options).hashes,
+    );
+    const common = editedHashes.filter((hash) => hashArray.includes(hash));
+
+    expect(common.length).toBeGreaterThanOrEqual(hashArray.length - 3);
+  },
+);
+
+test.each(variantNames.map((name) => [name]))('empty data', (name) => {
+  const { oneshotChunks } = lib[name];
+
+  for (const chunking of ['fixed', 'cdc'] as const) {
+    const actual = oneshotChunks(Uint8Array.of(), { chunking, chunkSize: 64 });
+
+    expect(actual.offsets.length).toBe(0);
+    expect(actual.hashes.length).toBe(0);
+  }
+});
+
+test.each(variantNames.map((name) => [name]))('throws', (name) => {
+  const { oneshotChunks } = lib[name];
+
+  expect(() =>
+    oneshotChunks(data, { chunking: 'gear' as never, chunkSize: 4096 }),
+  ).toThrowError(
+    Error('"chunking" property is expected to be one of \'fixed\', \'cdc\''),
+  );
+  expect(() =>
+    oneshotChunks(data, { chunking: 'cdc', chunkSize: 32 }),
+  ).toThrowError(
+    Error(
+      '"chunkSize" property is expected to be at least 64 in the \'cdc\' mode',
+    ),
+  );
+  expect(() =>
+    oneshotChunks(data, {
+      chunking: 'cdc',
+      chunkSize: 4096,
+      minChunkSize: 8192,
+    }),
+  ).toThrowError(
+    Error('"minChunkSize" property is expected to be at most chunkSize'),
+  );
+  expect(() =>
+    oneshotChunks(data, {
+      chunking: 'cdc',
+      chunkSize: 4096,
+      maxChunkSize: 1024,
+    }),
+  ).toThrowError(
+    Error('"maxChunkSize" property is expected to be at least chunkSize'),
+  );
+});
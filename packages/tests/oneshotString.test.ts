@@ -0,0 +1,41 @@
+import { expect, test } from 'vitest';
+import lib from 'xxhash-bindings';
+import { variantNames } from './utils';
+
+const strings = [
+  '',
+  'abcd',
+  'é€😀',
+  // Lone surrogates are encoded as U+FFFD.
+  'a\ud800b\udc00',
+  // Around the size of the inline encode buffer.
+  ...[1018, 1019, 1020, 1021, 1022, 1023, 1024].flatMap((length) => [
+    'a'.repeat(length),
+    'a'.repeat(length - 1) + '😀',
+    'a'.repeat(length - 2) + '€',
+  ]),
+  '😀'.repeat(10000),
+];
+
+test.each(variantNames.map((name) => [name]))('oneshotString', (name) => {
+  const { oneshot, oneshotString } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    for (const string of strings) {
+      expect(oneshotString(string, seed)).toBe(
+        oneshot(Buffer.from(string), seed),
+      );
+    }
+  }
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'oneshotString throws on invalid data',
+  (name) => {
+    const { oneshotString } = lib[name];
+
+    expect(() =>
+      oneshotString(Uint8Array.of() as unknown as string),
+    ).toThrowError(Error('Expected type of the parameter "data" is string'));
+  },
+);
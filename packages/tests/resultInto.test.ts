@@ -0,0 +1,138 @@
+import { expect, test } from 'vitest';
+import lib, { XxVariantName } from 'xxhash-bindings';
+import { createResultArray, testData, variantNames } from './utils';
+
+const data = Uint8Array.from([97, 98, 99, 100]);
+
+const resultSizes: Record<XxVariantName, number> = {
+  xxhash32: 4,
+  xxhash64: 8,
+  xxhash3: 8,
+  xxhash3_128: 16,
+};
+
+// Reads a result stored in the native byte order.
+function readResult(name: XxVariantName, bytes: Uint8Array): number | bigint {
+  const copy = bytes.slice(0, resultSizes[name]);
+
+  switch (name) {
+    case 'xxhash32':
+      return new Uint32Array(copy.buffer)[0];
+    case 'xxhash3_128': {
+      const [low, high] = new BigUint64Array(copy.buffer);
+
+      return low | (high << BigInt(64));
+    }
+    default:
+      return new BigUint64Array(copy.buffer)[0];
+  }
+}
+
+// Runs store with each kind of the destination and checks that only the result
+// bytes at the offset are written.
+function expectStoresResult(
+  name: XxVariantName,
+  expected: number | bigint,
+  store: (
+    out: Uint8Array | Uint32Array | BigUint64Array,
+    offset?: number,
+  ) => void,
+) {
+  const resultSize = resultSizes[name];
+
+  for (const offset of [undefined, 0, 3]) {
+    const bytes = new Uint8Array(resultSize + 8).fill(0xff);
+    store(bytes, offset);
+
+    const start = offset ?? 0;
+    expect(readResult(name, bytes.subarray(start))).toBe(expected);
+    expect(bytes.subarray(0, start).every((b) => b === 0xff)).toBe(true);
+    expect(
+      bytes.subarray(start + resultSize).every((b) => b === 0xff),
+    ).toBe(true);
+  }
+
+  // The offset is measured in elements, even for xxhash3_128.
+  const out = createResultArray(name, 2);
+  store(out, 1);
+
+  const outBytes = new Uint8Array(out.buffer, out.BYTES_PER_ELEMENT);
+  expect(readResult(name, outBytes)).toBe(expected);
+}
+
+test.each(variantNames.map((name) => [name]))('oneshotInto', (name) => {
+  const { oneshot, oneshotInto } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    expectStoresResult(name, oneshot(data, seed), (out, offset) =>
+      oneshotInto(data, seed, out as never, offset),
+    );
+  }
+});
+
+test.each(variantNames.map((name) => [name]))('resultInto', (name) => {
+  const { createState, oneshot } = lib[name];
+
+  const state = createState(1);
+  state.update(data);
+
+  expectStoresResult(name, oneshot(data, 1), (out, offset) =>
+    state.resultInto(out as never, offset),
+  );
+});
+
+test.each(variantNames.map((name) => [name]))('fileInto', (name) => {
+  const { file, fileInto } = lib[name];
+
+  for (const preferMap of [false, true]) {
+    const options = { path: testData('image1.png'), preferMap };
+
+    expectStoresResult(name, file(options), (out, offset) =>
+      fileInto(options, out as never, offset),
+    );
+  }
+});
+
+test.each<[XxVariantName, string]>([
+  ['xxhash32', 'Uint8Array or Uint32Array'],
+  ['xxhash64', 'Uint8Array or BigUint64Array'],
+  ['xxhash3', 'Uint8Array or BigUint64Array'],
+  ['xxhash3_128', 'Uint8Array or BigUint64Array'],
+])('throws on invalid out', (name, expectedType) => {
+  const { oneshotInto } = lib[name];
+
+  expect(() =>
+    oneshotInto(data, 0, new Float64Array(4) as never),
+  ).toThrowError(
+    Error(`Expected type of the parameter "out" is ${expectedType}`),
+  );
+
+  const error = Error(
+    '"offset" parameter is expected to leave enough room for the result in out',
+  );
+
+  expect(() =>
+    oneshotInto(data, 0, new Uint8Array(resultSizes[name] - 1)),
+  ).toThrowError(error);
+  expect(() =>
+    oneshotInto(data, 0, new Uint8Array(resultSizes[name]), 1),
+  ).toThrowError(error);
+  expect(() =>
+    oneshotInto(data, 0, new Uint8Array(resultSizes[name]), 100),
+  ).toThrowError(error);
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'fileInto validates out before reading',
+  (name) => {
+    const { fileInto } = lib[name];
+
+    expect(() =>
+      fileInto({ path: testData('non-existent') }, new Uint8Array(1)),
+    ).toThrowError(
+      Error(
+        '"offset" parameter is expected to leave enough room for the result in out',
+      ),
+    );
+  },
+);
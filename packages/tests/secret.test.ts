@@ -0,0 +1,149 @@
+import { expect, test } from 'vitest';
+import lib, { generateSecret } from 'xxhash-bindings';
+import { testData } from './utils';
+
+const secretVariantNames = ['xxhash3', 'xxhash3_128'] as const;
+
+const longData = Uint8Array.from([...Array(1000).keys()].map((i) => i % 256));
+
+test('generateSecret', () => {
+  const fromSeed = generateSecret(1);
+
+  expect(fromSeed.length).toBe(192);
+  expect(generateSecret(BigInt(1))).toEqual(fromSeed);
+  expect(generateSecret(2)).not.toEqual(fromSeed);
+
+  const fromBytes = generateSecret(Uint8Array.from([97, 98, 99]));
+
+  expect(fromBytes.length).toBe(192);
+  expect(generateSecret(Uint8Array.of())).not.toEqual(fromBytes);
+  expect(
+    lib.xxhash3.oneshot(Uint8Array.from([97, 98, 99, 100]), fromBytes),
+  ).toBe(BigInt('0x79ab0616f1b5953'));
+});
+
+test.each(secretVariantNames.map((name) => [name]))(
+  'secret derived from seed',
+  (name) => {
+    const { oneshot } = lib[name];
+
+    // Inputs longer than 240 bytes are hashed with the secret derived from
+    // the seed.
+    expect(oneshot(longData, generateSecret(5))).toBe(oneshot(longData, 5));
+  },
+);
+
+test.each(secretVariantNames.map((name) => [name]))(
+  'oneshot and state',
+  (name) => {
+    const { oneshot, oneshotBatch, createState } = lib[name];
+    const secret = generateSecret(Uint8Array.of(1, 2, 3));
+
+    for (const length of [0, 1, 16, 200, 241, 1000]) {
+      const data = longData.subarray(0, length);
+      const expected = oneshot(data, secret);
+
+      expect(expected).not.toBe(oneshot(data));
+
+      const state = createState(secret);
+      state.update(data.subarray(0, length / 2));
+      state.update(data.subarray(length / 2));
+
+      expect(state.result()).toBe(expected);
+
+      state.reset();
+      state.update(data);
+      expect(state.result()).toBe(expected);
+    }
+
+    const batch = oneshotBatch([longData], secret);
+    expect(batch[0]).toBe(BigInt.asUintN(64, oneshot(longData, secret)));
+  },
+);
+
+test.each(secretVariantNames.map((name) => [name]))(
+  'state copies the secret',
+  (name) => {
+    const { oneshot, createState } = lib[name];
+    const secret = generateSecret(1);
+    const expected = oneshot(longData, secret);
+
+    const state = createState(secret);
+    secret.fill(0);
+    const clone = state.clone();
+    state.update(longData);
+
+    expect(state.result()).toBe(expected);
+
+    clone.update(longData);
+    expect(clone.result()).toBe(expected);
+  },
+);
+
+test.each(secretVariantNames.map((name) => [name]))('file', async (name) => {
+  const { oneshot, oneshotChunks, file, fileAsync, directoryToMap } = lib[name];
+  const secret = generateSecret(1);
+  const options = { path: testData('image1.png'), secret };
+
+  const expected = file(options);
+
+  expect(expected).not.toBe(file({ path: options.path }));
+  expect(file({ ...options, preferMap: true })).toBe(expected);
+  await expect(fileAsync(options)).resolves.toBe(expected);
+
+  const directory = directoryToMap({ path: testData('dir'), secret });
+  expect(directory.get('file1.txt')).toBe(
+    file({ path: testData('dir/file1.txt'), secret }),
+  );
+
+  const chunks = oneshotChunks(longData, { chunkSize: 100, secret });
+  expect(chunks.hashes[0]).toBe(
+    BigInt.asUintN(64, oneshot(longData.subarray(0, 100), secret)),
+  );
+});
+
+test.each(secretVariantNames.map((name) => [name]))(
+  'throws on invalid secret',
+  (name) => {
+    const { oneshot, file } = lib[name];
+
+    expect(() => oneshot(longData, new Uint8Array(135))).toThrowError(
+      Error('"seed" parameter is expected to be at least 136 bytes long'),
+    );
+
+    expect(() =>
+      file({ path: testData('image1.png'), secret: [] as never }),
+    ).toThrowError(
+      Error(
+        'Expected type of the property "secret" is Uint8Array or undefined',
+      ),
+    );
+
+    expect(() =>
+      file({
+        path: testData('image1.png'),
+        secret: generateSecret(1),
+        seed: 1,
+      }),
+    ).toThrowError(
+      Error(
+        '"seed" property is expected to be undefined when secret is specified',
+      ),
+    );
+  },
+);
+
+test.each(['xxhash32', 'xxhash64'].map((name) => [name]))(
+  'secret is not supported',
+  (name) => {
+    const { file } = lib[name as 'xxhash32' | 'xxhash64'];
+
+    expect(() =>
+      file({ path: testData('image1.png'), secret: generateSecret(1) }),
+    ).toThrowError(
+      Error(
+        '"secret" property is expected to be undefined for xxhash32 and xxhash64',
+      ),
+    );
+  },
+);
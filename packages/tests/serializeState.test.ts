@@ -0,0 +1,79 @@
+import { expect, test } from 'vitest';
+import lib, { generateSecret, XxVariantName } from 'xxhash-bindings';
+import { variantNames } from './utils';
+
+const data = Uint8Array.from([...Array(5000).keys()].map((i) => i % 251));
+
+test.each(variantNames.map((name) => [name]))('round trip', (name) => {
+  const { createState, oneshot } = lib[name];
+
+  for (const seed of [undefined, 1]) {
+    for (const prefixLength of [0, 3, 100, 1500]) {
+      const state = createState(seed);
+      state.update(data.subarray(0, prefixLength));
+
+      const restored = createState.fromSerialized(state.serialize());
+      expect(restored.result()).toBe(state.result());
+
+      restored.update(data.subarray(prefixLength));
+      expect(restored.result()).toBe(oneshot(data, seed));
+
+      // The seed is restored too.
+      restored.reset();
+      expect(restored.result()).toBe(oneshot(Uint8Array.of(), seed));
+    }
+  }
+});
+
+test.each([['xxhash3'], ['xxhash3_128']] as const)(
+  'round trip with secret',
+  (name) => {
+    const { createState, oneshot } = lib[name];
+    const secret = generateSecret(1);
+
+    const state = createState(secret);
+    state.update(data.subarray(0, 1000));
+
+    const restored = createState.fromSerialized(state.serialize());
+    restored.update(data.subarray(1000));
+
+    expect(restored.result()).toBe(oneshot(data, secret));
+  },
+);
+
+test.each(variantNames.map((name) => [name]))(
+  'throws on invalid data',
+  (name) => {
+    const { createState } = lib[name];
+    const serialized = createState(1).serialize();
+
+    const invalidError = Error(
+      '"data" parameter is expected to be a serialized hash state',
+    );
+
+    expect(() => createState.fromSerialized(Uint8Array.of())).toThrowError(
+      invalidError,
+    );
+    expect(() =>
+      createState.fromSerialized(serialized.subarray(0, serialized.length - 1)),
+    ).toThrowError(invalidError);
+
+    const otherVersion = serialized.slice();
+    otherVersion[4] = 100;
+
+    expect(() => createState.fromSerialized(otherVersion)).toThrowError(
+      Error(
+        '"data" parameter is expected to be serialized by a compatible version of the library',
+      ),
+    );
+
+    const otherName: XxVariantName =
+      name === 'xxhash32' ? 'xxhash64' : 'xxhash32';
+
+    expect(() =>
+      createState.fromSerialized(lib[otherName].createState().serialize()),
+    ).toThrowError(
+      Error(`"data" parameter is expected to be a serialized ${name} state`),
+    );
+  },
+);
@@ -0,0 +1,62 @@
+import { expect, test } from 'vitest';
+import lib from 'xxhash-bindings';
+import { variantNames } from './utils';
+
+const data = Uint8Array.from([97, 98, 99, 100]);
+
+test.each(variantNames.map((name) => [name]))('reuses states', (name) => {
+  const { createStatePool, oneshot } = lib[name];
+  const pool = createStatePool({ size: 1, seed: 1 });
+
+  const first = pool.acquire();
+  first.update(data);
+  expect(first.result()).toBe(oneshot(data, 1));
+
+  const second = pool.acquire();
+  expect(second).not.toBe(first);
+
+  pool.release(first);
+  pool.release(second);
+
+  // The released state is reset.
+  const reused = pool.acquire();
+  expect(reused).toBe(first);
+  expect(reused.result()).toBe(oneshot(Uint8Array.of(), 1));
+
+  // The pool is full, the other one is disposed.
+  expect(() => second.result()).toThrowError(Error('The state is disposed'));
+});
+
+test.each(variantNames.map((name) => [name]))(
+  'throws on foreign states',
+  (name) => {
+    const { createState, createStatePool } = lib[name];
+    const pool = createStatePool({ size: 4 });
+    const error = Error('The state is not acquired from the pool');
+
+    expect(() => pool.release(createState())).toThrowError(error);
+
+    const state = pool.acquire();
+    pool.release(state);
+
+    expect(() => pool.release(state)).toThrowError(error);
+    expect(() => createStatePool({ size: -1 })).toThrowError(
+      Error('"size" property is expected to be a non-negative integer'),
+    );
+  },
+);
+
+test.each(variantNames.map((name) => [name]))('dispose', (name) => {
+  const { createState } = lib[name];
+  const state = createState();
+
+  state.dispose();
+  state.dispose();
+
+  const error = Error('The state is disposed');
+
+  expect(() => state.update(data)).toThrowError(error);
+  expect(() => state.result()).toThrowError(error);
+  expect(() => state.reset()).toThrowError(error);
+  expect(() => state.updateAsync(data)).toThrowError(error);
+});
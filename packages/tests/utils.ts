@@ -1,4 +1,5 @@
 import path from 'path';
+import { XxVariantName } from 'xxhash-bindings';
 
 export const variantNames = [
   'xxhash32',
@@ -7,6 +8,39 @@ export const variantNames = [
   'xxhash3_128',
 ] as const;
 
+// Converts an array of hash results to their values: each xxhash3_128 result
+// takes two elements, the low half first.
+export function hashResultsToArray(
+  name: XxVariantName,
+  results: Uint32Array | BigUint64Array,
+): (number | bigint)[] {
+  if (name === 'xxhash3_128') {
+    const values = results as BigUint64Array;
+
+    return [...Array(values.length / 2).keys()].map(
+      (i) => values[2 * i] | (values[2 * i + 1] << BigInt(64)),
+    );
+  }
+
+  return [...results];
+}
+
+// Creates an array that holds count hash results, laid out like the arrays
+// returned by the batch functions.
+export function createResultArray(
+  name: XxVariantName,
+  count: number,
+): Uint32Array | BigUint64Array {
+  switch (name) {
+    case 'xxhash32':
+      return new Uint32Array(count);
+    case 'xxhash3_128':
+      return new BigUint64Array(count * 2);
+    default:
+      return new BigUint64Array(count);
+  }
+}
+
 export const TEST_DATA_PATH = './test_data';
 
 export function testData(path: string): string {
@@ -15,6 +15,12 @@ const alias = Object.fromEntries(
   ]),
 );
 
+// Maps files by 1 MiB windows instead of 256 MiB ones, see
+// MemoryMappedFile::GetWindowSize(). Set here rather than in test.env, as the
+// addon reads the environment of the process, which the test threads don't
+// change.
+process.env.XXHASH_BINDINGS_MAP_WINDOW_SIZE = String(1024 * 1024);
+
 export default defineConfig({
   resolve: {
     alias,